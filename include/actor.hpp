@@ -15,6 +15,9 @@ private:
 
     int m_LOSRadius;
 
+    // how often the actor gets to act, NORMAL_SPEED acts once per turn
+    int m_Speed;
+
     std::vector<Attribute> m_Attributes;
     std::vector<Item*> m_Inventory;
 
@@ -26,6 +29,10 @@ public:
     void setLOSRadious(int nrad) { m_LOSRadius = nrad;}
     int getLOSRadius() const { return m_LOSRadius;}
 
+    void setSpeed(int nspeed) { m_Speed = nspeed;}
+    int getSpeed() const { return m_Speed;}
+    long getActionDelay() const;
+
     bool addItemToInventory(Item *titem);
     std::vector<Item*> *getInventory() { return &m_Inventory;}
 
@@ -35,6 +42,6 @@ public:
     bool loadFromXMLNode(XMLNode *tnode);
     void printInfo() const;
 
-
+    friend class DataPack;
 };
 #endif // CLASS_ACTOR
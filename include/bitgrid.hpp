@@ -0,0 +1,53 @@
+#ifndef CLASS_BITGRID
+#define CLASS_BITGRID
+
+#include <vector>
+#include <stdint.h>
+
+// forward declaration
+class Random;
+
+// 2d grid of bits packed 64 cells to a word, row by row
+// cells outside the grid read as set, so the unused bits at the end of
+// each row are kept set
+class BitGrid
+{
+private:
+
+    int m_Width;
+    int m_Height;
+    int m_WordsPerRow;
+    std::vector<uint64_t> m_Words;
+
+    // bits past the width in the last word of a row
+    uint64_t m_PadMask;
+
+public:
+    BitGrid();
+    ~BitGrid();
+
+    void resize(int width, int height, bool value = false);
+
+    int getWidth() const { return m_Width;}
+    int getHeight() const { return m_Height;}
+    int getWordsPerRow() const { return m_WordsPerRow;}
+
+    bool get(int x, int y) const
+    {
+        if(x < 0 || y < 0 || x >= m_Width || y >= m_Height) return true;
+        return (m_Words[y*m_WordsPerRow + (x >> 6)] >> (x & 63)) & 1;
+    }
+    void set(int x, int y, bool value);
+    const uint64_t *getRow(int y) const { return &m_Words[y*m_WordsPerRow];}
+
+    // set each cell with the given probability
+    void fillRandom(Random *trng, float density);
+
+    // one cellular automata generation over the 8 neighbors
+    // bit n of birth/survival means a cell with n set neighbors becomes/stays set
+    void step(unsigned int birth, unsigned int survival);
+
+    int countSet() const;
+};
+
+#endif // CLASS_BITGRID
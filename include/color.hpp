@@ -6,6 +6,8 @@
 
 using namespace tinyxml2;
 
+#define MAX_COLORS 8
+
 bool initColors();
 
 struct COLOR
@@ -25,4 +27,9 @@ struct COLOR
 
 COLOR loadColorFromXMLNode(XMLNode *tnode);
 
+// color pair table, filled in by the engine once the display has made the pairs
+// pairs are 0 (default colors) until then, ie. in tools without a display
+void setColorPair(COLOR tcolor, int pair);
+int getColorPair(COLOR tcolor);
+
 #endif // CLASS_COLOR
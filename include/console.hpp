@@ -9,21 +9,29 @@
 
 #include <string>
 #include <vector>
+#include <stdarg.h>
 #include "color.hpp"
+#include "symbol.hpp"
 
 // forward decl
 class recti;
+class Renderer;
 
 class Command
 {
 private:
-    std::string m_Name;
+    Symbol m_Name;
     std::string m_Description;
     int m_Type;
 
     void (*m_Function)(std::vector<std::string> *cmd);
 
     std::vector<Command*> m_Children;
+
+    // children hashed on their name symbol, open addressing
+    std::vector<Command*> m_ChildTable;
+    void addToChildTable(Command *tcmd);
+
 public:
     Command(int cmdtype, std::string nname, std::string ndesc, void (*nfunct)(std::vector<std::string> *cmd) = NULL);
     ~Command();
@@ -31,20 +39,74 @@ public:
     // command type, is it a normal command or a submenu type command
     enum {C_CMD, C_SUBMENU};
 
-    std::string getName() const { return m_Name;}
-    std::string getDesc() const { return m_Description;}
+    const std::string &getName() const { return m_Name.str();}
+    Symbol getSymbol() const { return m_Name;}
+    const std::string &getDesc() const { return m_Description;}
     int getType() const {return m_Type;}
 
+    // takes ownership of the child
     bool addCommand(Command *ncommand);
     const std::vector< Command*> *getChildren() const { return &m_Children;}
+    // NULL if there is no child with that name
+    const Command *findChild(Symbol tname) const;
     bool execute(std::vector<std::string> *cmd) const;
     bool hasFunction() const;
 };
 
+// word of a command line, points into the line it was split from
+struct CommandToken
+{
+    const char *m_Str;
+    int m_Length;
+};
+
+// split a line on spaces without copying it, returns the token count
+int tokenizeCommand(const char *str, size_t len, std::vector<CommandToken> *tokens);
+
+// lines kept by the console and the game message log
+#define CONSOLE_LOG_SIZE 512
+#define MESSAGE_LOG_SIZE 128
+
+// run of message text drawn with the same attributes
+struct MessageSpan
+{
+    int m_Start;
+    int m_Length;
+    // color pair, -1 for the default colors
+    int m_Pair;
+    bool m_Bold;
+};
+
+// message with its %b (bold) and %c (color pair argument) codes already
+// applied, m_Text holds only the characters that are drawn
 struct ConsoleElement
 {
     std::string m_Text;
-    std::vector<int> m_Args;
+    std::vector<MessageSpan> m_Spans;
+};
+
+// fixed capacity ring of messages, once full the oldest entry is reused
+// so a long session does not keep allocating
+class MessageLog
+{
+private:
+
+    std::vector<ConsoleElement> m_Entries;
+    int m_First;
+    int m_Count;
+
+public:
+    MessageLog(int capacity = MESSAGE_LOG_SIZE);
+    ~MessageLog();
+
+    // entry for a new message, its old contents are left for the caller to overwrite
+    ConsoleElement *push();
+    void clear();
+
+    int size() const { return m_Count;}
+    int getCapacity() const { return int(m_Entries.size());}
+    // 0 is the oldest message
+    const ConsoleElement &operator[](int index) const { return m_Entries[ (m_First + index) % m_Entries.size()];}
 };
 
 class Console
@@ -56,12 +118,17 @@ private:
     static Console *m_Instance;
 
     bool initCommands();
-    std::vector<Command*> m_CommandList;
+    // top level menu
+    Command m_Root;
+
+    // reused by parseCommand so dispatch does not allocate
+    std::vector<CommandToken> m_Tokens;
+    std::vector<std::string> m_Args;
 
     std::string m_PromptString;
 
     // console message buffer
-    std::vector<ConsoleElement*> m_Buffer;
+    MessageLog m_Buffer;
     // console command buffer
     std::vector<std::string> m_CmdBuffer;
     int m_CmdBufferIndex;
@@ -70,17 +137,21 @@ public:
     static Console *getInstance();
 
     void openConsole();
-    void print(std::string str, ...);
+    void print(const std::string &str);
+    void print(const char *str, ...);
 
-    bool parseCommand(std::string tstr);
+    bool parseCommand(const std::string &tstr);
 
-    const std::vector<Command*> *getCommands() { return &m_CommandList;}
-    const Command *findCommand(std::vector<std::string> *cmd);
+    const std::vector<Command*> *getCommands() { return m_Root.getChildren();}
+    // deepest command matching the leading tokens, NULL if the first does not match
+    const Command *findCommand(const std::vector<CommandToken> &tokens) const;
 };
 
-void printMessages(std::vector<ConsoleElement*> *tlist, recti *trect = NULL);
-bool addMessage(std::vector<ConsoleElement*> *tlist, std::string str, ...);
-bool addMessageV(std::vector<ConsoleElement*> *tlist, std::string str, va_list v);
+int printMessages(const MessageLog *tlog, Renderer *trender, recti *trect = NULL);
+// formatted messages take one int color pair argument per %c
+bool addMessage(MessageLog *tlog, const std::string &str);
+bool addMessage(MessageLog *tlog, const char *str, ...);
+bool addMessageV(MessageLog *tlog, const char *str, va_list v);
 
 // commands
 class ConsoleFunction
@@ -95,9 +166,11 @@ public:
     static void gameNew(std::vector<std::string> *cmd);
     static void showItemInfo(std::vector<std::string> *cmd);
     static void giveItemToPlayer(std::vector<std::string> *cmd);
+    static void spawnItem(std::vector<std::string> *cmd);
     static void printItemList(std::vector<std::string> *cmd);
     static void printActorList(std::vector<std::string> *cmd);
     static void showActorInfo(std::vector<std::string> *cmd);
+    static void spawnActor(std::vector<std::string> *cmd);
     static void printMap(std::vector<std::string> *cmd);
     static void printMapItems(std::vector<std::string> *cmd);
     static void showMapItem(std::vector<std::string> *cmd);
@@ -105,6 +178,7 @@ public:
     static void showMapActor(std::vector<std::string> *cmd);
     static void mapExport(std::vector<std::string> *cmd);
     static void mapRegen(std::vector<std::string> *cmd);
+    static void mapLevel(std::vector<std::string> *cmd);
     static void mytest(std::vector<std::string> *cmd);
     static void colortest(std::vector<std::string> *cmd);
     static void printPlayer(std::vector<std::string> *cmd);
@@ -0,0 +1,35 @@
+#ifndef CLASS_DATAPACK
+#define CLASS_DATAPACK
+
+#include <string>
+#include <vector>
+
+// forward declarations
+class Tile;
+class Item;
+class Actor;
+class WorldObject;
+class glyph;
+struct PackGlyph;
+struct PackObject;
+
+#define DATAPACK_VERSION 1
+
+// compiled binary form of the tile, item and actor xml data
+// the pack is memory mapped and read straight into the engine tables,
+// it is rebuilt from the xml whenever any of the xml files are newer
+class DataPack
+{
+private:
+    DataPack() {};
+    ~DataPack() {};
+
+    static void packObject(const WorldObject &tobj, std::vector<char> *strings, PackObject *pobj);
+    static void unpackObject(const PackObject &pobj, const char *strings, WorldObject *tobj);
+
+public:
+    static bool isUpToDate(std::string packfile, const std::vector<std::string> &sources);
+    static bool write(std::string packfile, const std::vector<Tile> &tiles, const std::vector<Item*> &items, const std::vector<Actor*> &actors);
+    static bool read(std::string packfile, std::vector<Tile> *tiles, std::vector<Item*> *items, std::vector<Actor*> *actors);
+};
+#endif // CLASS_DATAPACK
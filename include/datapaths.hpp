@@ -0,0 +1,11 @@
+#ifndef CLASS_DATAPATHS
+#define CLASS_DATAPATHS
+
+// game data files, shared by the game and the tools
+#define TILES_XML ".\\data\\tiles.xml"
+#define ITEMS_XML ".\\data\\items.xml"
+#define ACTORS_XML ".\\data\\actors.xml"
+#define DATA_PACK ".\\data\\data.pak"
+#define PREFABS_XML ".\\data\\prefabs.xml"
+
+#endif // CLASS_DATAPATHS
@@ -0,0 +1,117 @@
+#ifndef CLASS_DISPLAY
+#define CLASS_DISPLAY
+
+#ifdef NCURSES
+#include <ncurses.h>
+#else
+#include "curses.h"
+#endif
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <ostream>
+
+// display and input backend
+// everything the engine shows or reads from the terminal goes through here
+class Display
+{
+public:
+    virtual ~Display() {};
+
+    virtual bool init()=0;
+    virtual void shutdown()=0;
+
+    virtual bool initColorPair(int pair, int foreground, int background)=0;
+
+    virtual int getWidth() const =0;
+    virtual int getHeight() const =0;
+
+    virtual void clearScreen()=0;
+    virtual void putCell(int x, int y, chtype ch)=0;
+    virtual void setCursor(int x, int y)=0;
+    virtual void showCursor(bool show)=0;
+    virtual void flush()=0;
+
+    virtual int getKey()=0;
+};
+
+// terminal backend
+class CursesDisplay: public Display
+{
+private:
+    bool m_Initialized;
+
+public:
+    CursesDisplay();
+    ~CursesDisplay();
+
+    bool init();
+    void shutdown();
+
+    bool initColorPair(int pair, int foreground, int background);
+
+    int getWidth() const;
+    int getHeight() const;
+
+    void clearScreen();
+    void putCell(int x, int y, chtype ch);
+    void setCursor(int x, int y);
+    void showCursor(bool show);
+    void flush();
+
+    int getKey();
+};
+
+// in-memory backend for benchmarks and tests, no terminal required
+// input comes from a scripted key queue, once it runs out escape is
+// returned so every screen (and the game) eventually quits
+class HeadlessDisplay: public Display
+{
+private:
+    int m_Width;
+    int m_Height;
+
+    std::vector<chtype> m_Screen;
+    std::deque<int> m_Keys;
+
+    unsigned int m_FrameCount;
+    unsigned int m_KeyCount;
+
+    // optional stream receiving every flushed frame
+    std::ostream *m_FrameLog;
+
+public:
+    HeadlessDisplay(int nwidth = 80, int nheight = 25);
+    ~HeadlessDisplay();
+
+    bool init() { return true;}
+    void shutdown() {};
+
+    bool initColorPair(int /*pair*/, int /*foreground*/, int /*background*/) { return true;}
+
+    int getWidth() const { return m_Width;}
+    int getHeight() const { return m_Height;}
+
+    void clearScreen();
+    void putCell(int x, int y, chtype ch);
+    void setCursor(int /*x*/, int /*y*/) {};
+    void showCursor(bool /*show*/) {};
+    void flush();
+
+    int getKey();
+
+    // scripted input
+    void pushKey(int key);
+    void pushKeys(const std::string &keys);
+    bool loadKeys(std::string fname);
+    bool hasKeys() const { return !m_Keys.empty();}
+
+    // inspection
+    chtype getCell(int x, int y) const;
+    std::string getScreenText() const;
+    void setFrameLog(std::ostream *tlog) { m_FrameLog = tlog;}
+    unsigned int getFrameCount() const { return m_FrameCount;}
+    unsigned int getKeyCount() const { return m_KeyCount;}
+};
+#endif // CLASS_DISPLAY
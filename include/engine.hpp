@@ -16,16 +16,21 @@
 #include "camera.hpp"
 #include "console.hpp"
 #include "item.hpp"
+#include "fov.hpp"
+#include "renderer.hpp"
+#include "display.hpp"
+#include "random.hpp"
+#include "levelgen.hpp"
+#include "prefab.hpp"
+#include "workerpool.hpp"
+#include "datapaths.hpp"
 
 #include <tinyxml2.h>
 
 #define ENABLE_COLOR 1
-#define MAX_COLORS 8
 
-
-#define TILES_XML ".\\data\\tiles.xml"
-#define ITEMS_XML ".\\data\\items.xml"
-#define ACTORS_XML ".\\data\\actors.xml"
+// levels built up front when a new game starts
+#define NEWGAME_LEVELS 4
 
 
 // namespace
@@ -47,7 +52,7 @@ private:
     static Engine *m_Instance;
 
     // init
-    bool initCurses();
+    bool initDisplay();
     bool initConsole();
     bool initColors();
 
@@ -55,25 +60,33 @@ private:
     bool processXML(std::string xfile);
 
     Camera m_Camera;
+    Display *m_Display;
+    Renderer m_Renderer;
 
     // master game data
-    std::vector< std::vector <int> > m_ColorTable;
     std::vector<Tile> m_Tiles;
     std::vector<Item*> m_Items;
     std::vector<Actor*> m_Actors;
+    std::vector<Prefab> m_Prefabs;
 
     // console
     Console *m_Console;
 
     // current game data
-    void newGame();
+    void newGame(uint64_t nseed = 0);
     void clearGame();
-    time_t m_Seed;
+    uint64_t m_Seed;
+    Random m_Random;
+    Random getRandomStream(E_RNGSTREAM stype, unsigned int index = 0) const;
     Actor *m_Player;
     unsigned int m_PlayerMoveCount;
+
+    // wall clock seconds spent starting up and in the main loop
+    double m_StartupTime;
+    double m_MainLoopTime;
     int m_CurrentLevel;
     std::vector<Map*> m_Levels;
-    std::vector<ConsoleElement*> m_MessageLog;
+    MessageLog m_MessageLog;
 
     // main
     void mainLoop();
@@ -82,9 +95,13 @@ private:
 
     // draw
     void drawCamera(Camera *tcamera);
-    bool inLOS(int x1, int y1, int x2, int y2);
+    bool isCellDrawn(const Map *tmap, int x, int y) const;
     void drawUI(int x, int y);
 
+    // player field of view, computed once per turn
+    FieldOfView m_PlayerFOV;
+    void updatePlayerFOV();
+
 
     // actor
     bool walkActor(Actor *tactor, int dir, bool noclip=false);
@@ -93,9 +110,23 @@ private:
     Item *dropItem();
     bool addActorToMap(Map *tlevel, Actor *tactor, int x, int y);
     Actor *newActor(int aindex);
+    // create an actor on a level, the level allocates it from its pool
+    Actor *newActor(int aindex, Map *tlevel, int x, int y);
 
     // level
-    bool generateLevel(Map *tmap);
+    LevelGenerator m_LevelGen;
+    WorkerPool m_Workers;
+    bool generateLevel(Map *tmap, Random *trng);
+    void generateLevels(int first, int count);
+
+    // the level after the deepest built one is generated in the background
+    // and only added to m_Levels once it is finished
+    LevelJob *m_NextLevelJob;
+    int m_NextLevel;
+    void pregenerateLevel(int level);
+    void cancelPregeneration();
+    Map *getLevel(int level);
+    bool changeLevel(int level);
     bool lightPassesThroughAt(int x, int y, Map *tmap = NULL);
     bool isWalkableAt(int x, int y, Map *tmap = NULL);
     bool openDoorAt(int x, int y, Map *tmap = NULL);
@@ -115,17 +146,25 @@ private:
 public:
     static Engine *getInstance();
 
+    // engine takes ownership of the display, defaults to curses
+    void setDisplay(Display *tdisplay);
     void start();
 
     // get stuff from main engine
     int getColorPair(COLOR tcolor);
+    Renderer *getRenderer() { return &m_Renderer;}
+    Display *getDisplay() { return m_Display;}
     const Map *getCurrentMap() { return m_Levels[m_CurrentLevel];}
     const std::vector<Item*> *getItemList() { return &m_Items;}
     const std::vector<Actor*> *getActorList() { return &m_Actors;}
     unsigned int getPlayerMoveCount() const { return m_PlayerMoveCount;}
+    double getStartupTime() const { return m_StartupTime;}
+    double getMainLoopTime() const { return m_MainLoopTime;}
 
     // create item
     Item *newItem(int itmindex);
+    // create an item on a level, the level allocates it from its pool
+    Item *newItem(int itmindex, Map *tlevel, int x, int y);
 
     // other
     void exportMapToASCIIFile(const Map *tmap, std::string fname = std::string("mapexport.txt"));
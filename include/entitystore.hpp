@@ -0,0 +1,123 @@
+#ifndef CLASS_ENTITYSTORE
+#define CLASS_ENTITYSTORE
+
+#include <vector>
+
+#ifdef NCURSES
+#include <ncurses.h>
+#else
+#include "curses.h"
+#endif
+
+#include "tools.hpp"
+#include "glyph.hpp"
+#include "slotmap.hpp"
+
+// cell flags an entity contributes
+enum E_ENTITYFLAG{ ENT_BLOCKSMOVE = 0x01, ENT_BLOCKSLIGHT = 0x02};
+
+// map objects with their hot fields copied into parallel dense arrays
+// bulk passes (drawing, cell flags) read positions, render glyphs and
+// flags from contiguous memory and only touch the object itself for
+// cold data like names
+// the map keeps the arrays in sync through sync() when an object moves
+// or changes, the object stays the authority for its own fields
+template <class T>
+class EntityStore
+{
+private:
+
+    SlotMap<T*> m_Objects;
+
+    // same order as the slot map's dense array
+    std::vector<vector2i> m_Positions;
+    std::vector<chtype> m_Render;
+    std::vector<unsigned char> m_Flags;
+
+    void read(int index, T *tobj)
+    {
+        const glyph &tglyph = tobj->getGlyph();
+
+        m_Positions[index] = tobj->getPosition();
+        m_Render[index] = tglyph.m_Render;
+        m_Flags[index] = (tglyph.m_Walkable ? 0 : ENT_BLOCKSMOVE) | (tglyph.m_PassesLight ? 0 : ENT_BLOCKSLIGHT);
+    }
+
+public:
+    EntityStore() {};
+    ~EntityStore() {};
+
+    EntityHandle insert(T *tobj)
+    {
+        EntityHandle thandle = m_Objects.insert(tobj);
+
+        m_Positions.push_back(vector2i());
+        m_Render.push_back(0);
+        m_Flags.push_back(0);
+        read(int(m_Positions.size()) - 1, tobj);
+
+        return thandle;
+    }
+
+    bool remove(const EntityHandle &thandle)
+    {
+        int index = m_Objects.getDenseIndex(thandle);
+        if(index < 0) return false;
+
+        m_Objects.remove(thandle);
+
+        // follow the slot map's swap and pop
+        m_Positions[index] = m_Positions.back();
+        m_Render[index] = m_Render.back();
+        m_Flags[index] = m_Flags.back();
+        m_Positions.pop_back();
+        m_Render.pop_back();
+        m_Flags.pop_back();
+
+        return true;
+    }
+
+    // copy the object's current fields, false if the handle is stale
+    bool sync(const EntityHandle &thandle)
+    {
+        int index = m_Objects.getDenseIndex(thandle);
+        if(index < 0) return false;
+
+        read(index, m_Objects[index]);
+
+        return true;
+    }
+
+    void setPosition(const EntityHandle &thandle, vector2i tpos)
+    {
+        int index = m_Objects.getDenseIndex(thandle);
+        if(index >= 0) m_Positions[index] = tpos;
+    }
+
+    // invalidates every handle
+    void clear()
+    {
+        m_Objects.clear();
+        m_Positions.clear();
+        m_Render.clear();
+        m_Flags.clear();
+    }
+
+    // NULL if the handle is stale
+    T *get(const EntityHandle &thandle) const
+    {
+        T * const *tobj = m_Objects.get(thandle);
+
+        return tobj ? *tobj : NULL;
+    }
+
+    int size() const { return m_Objects.size();}
+    const std::vector<T*> &getObjects() const { return m_Objects.getValues();}
+
+    // dense columns, index 0 to size()-1
+    const vector2i *getPositions() const { return m_Positions.empty() ? NULL : &m_Positions[0];}
+    const chtype *getRender() const { return m_Render.empty() ? NULL : &m_Render[0];}
+    const unsigned char *getFlags() const { return m_Flags.empty() ? NULL : &m_Flags[0];}
+};
+
+#endif // CLASS_ENTITYSTORE
@@ -0,0 +1,43 @@
+#ifndef CLASS_FOV
+#define CLASS_FOV
+
+#include <vector>
+
+#include "tools.hpp"
+
+// forward declaration
+class Map;
+
+// recursive shadowcasting field of view
+// computes every cell visible from an origin within a square radius
+// and stores the result in a bitmask centered on the origin
+class FieldOfView
+{
+private:
+
+    vector2i m_Origin;
+    int m_Radius;
+    int m_Size;
+
+    // one bit per cell, (2*radius+1)^2 cells, row-major
+    std::vector<unsigned int> m_Bits;
+
+    // map being scanned by the current computation
+    const Map *m_Map;
+
+    void setVisible(int x, int y);
+    void castLight(int row, float start, float end, int xx, int xy, int yx, int yy);
+
+public:
+    FieldOfView();
+    ~FieldOfView();
+
+    void compute(const Map *tmap, vector2i origin, int radius);
+    void clear();
+
+    bool isVisible(int x, int y) const;
+
+    vector2i getOrigin() const { return m_Origin;}
+    int getRadius() const { return m_Radius;}
+};
+#endif // CLASS_FOV
@@ -13,6 +13,9 @@
 
 using namespace tinyxml2;
 
+// forward declaration
+class Renderer;
+
 class glyph
 {
 public:
@@ -25,9 +28,14 @@ public:
     bool m_PassesLight;
     bool m_CanPickup;
 
+    // ready to draw character with color pair and bold attributes
+    // call resolve() after changing m_Character or m_Color
+    chtype m_Render;
+    void resolve();
+
     void printInfo() const;
 
-    void draw(int x, int y);
+    void draw(Renderer *trender, int x, int y) const;
 
     bool loadFromXMLNode(XMLNode *tnode);
 };
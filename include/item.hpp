@@ -2,6 +2,7 @@
 #define CLASS_ITEM
 
 #include "worldobject.hpp"
+#include "objectpool.hpp"
 #include <vector>
 
 #include <tinyxml2.h>
@@ -55,10 +56,24 @@ protected:
     float m_Weight;
 
     Door *m_Door;
+    // pool m_Door came from, NULL if it was allocated with new
+    ObjectPool<Door> *m_DoorPool;
+    // slot of m_Door in m_DoorPool
+    int m_DoorSlot;
+
+    void releaseDoor();
+    void copyFrom(const Item &titem);
+
+    // links to the other items sharing this map cell, managed by Map
+    Item *m_CellPrev;
+    Item *m_CellNext;
 public:
     Item();
     Item(const Item &titem);
+    // copy that allocates its door from a pool
+    Item(const Item &titem, ObjectPool<Door> *doorpool);
     ~Item();
+    Item &operator=(const Item &titem);
 
     virtual OBJTYPE getType() { return OBJ_ITEM;}
 
@@ -73,10 +88,18 @@ public:
     const Door *getDoor();
     bool openDoor();
 
+    // next item in the same map cell, NULL if this is the last one
+    Item *getNextItemInCell() const { return m_CellNext;}
+
     void update() {};
+    // items (and doors) have no behavior yet
+    bool needsUpdate() const { return false;}
 
     bool loadFromXMLNode(XMLNode *tnode);
     virtual void printInfo();
+
+    friend class Map;
+    friend class DataPack;
 };
 
 #endif // CLASS_ITEM
@@ -0,0 +1,108 @@
+#ifndef CLASS_LEVELGEN
+#define CLASS_LEVELGEN
+
+#include <cstddef>
+#include <vector>
+
+#include "random.hpp"
+#include "workerpool.hpp"
+
+// tile indices the generator writes
+#define TILE_NONE 0
+#define TILE_WALL 1
+#define TILE_FLOOR 2
+
+enum E_LEVELTYPE{LEVEL_ROOMS, LEVEL_CAVES, LEVEL_TOTAL};
+
+// forward declarations
+class Map;
+class Prefab;
+
+// what the generator did, for tuning
+struct LevelGenInfo
+{
+    int m_RoomCount;
+    int m_PrefabCount;
+    int m_RegionCount; // separate floor regions before they were connected
+    int m_CorridorCount;
+
+    LevelGenInfo() : m_RoomCount(0), m_PrefabCount(0), m_RegionCount(0), m_CorridorCount(0) {};
+};
+
+// builds a level layout into a map
+// generation only touches the map and rng it is handed, so different
+// levels can be generated at the same time from different threads
+class LevelGenerator
+{
+private:
+
+    E_LEVELTYPE m_Type;
+
+    // generation parameters
+    bool m_AllowOverlap; // allow rooms to be placed over rooms
+    bool m_AddWallBorder;
+    bool m_ConnectRegions; // carve corridors until every floor tile is reachable
+    float m_RoomDensity; // room placement attempts per map tile
+    int m_RoomWidthMin;
+    int m_RoomWidthMax;
+    int m_RoomHeightMin;
+    int m_RoomHeightMax;
+
+    // prefabs stamped into room levels, not owned
+    const std::vector<Prefab> *m_Prefabs;
+    float m_PrefabDensity; // prefab placement attempts per map tile
+
+    // cave parameters
+    float m_CaveFill; // chance a cell starts as wall
+    int m_CaveIterations;
+    unsigned int m_CaveBirth; // bit n set, floor with n wall neighbors becomes wall
+    unsigned int m_CaveSurvival; // bit n set, wall with n wall neighbors stays wall
+
+    bool generateRooms(Map *tmap, Random *trng, LevelGenInfo *tinfo) const;
+    bool generateCaves(Map *tmap, Random *trng, LevelGenInfo *tinfo) const;
+
+    // passes run after the layout
+    void connectRegions(Map *tmap, LevelGenInfo *tinfo) const;
+    void addWallBorders(Map *tmap) const;
+
+public:
+    LevelGenerator();
+    ~LevelGenerator();
+
+    void setAllowOverlap(bool noverlap) { m_AllowOverlap = noverlap;}
+    void setAddWallBorder(bool nborder) { m_AddWallBorder = nborder;}
+    void setConnectRegions(bool nconnect) { m_ConnectRegions = nconnect;}
+    void setRoomDensity(float ndensity) { m_RoomDensity = ndensity;}
+    void setRoomSize(int wmin, int wmax, int hmin, int hmax);
+    void setPrefabs(const std::vector<Prefab> *tprefabs) { m_Prefabs = tprefabs;}
+    void setPrefabDensity(float ndensity) { m_PrefabDensity = ndensity;}
+
+    void setType(E_LEVELTYPE ntype) { m_Type = ntype;}
+    E_LEVELTYPE getType() const { return m_Type;}
+    void setCaveFill(float nfill) { m_CaveFill = nfill;}
+    void setCaveIterations(int niterations) { m_CaveIterations = niterations;}
+    void setCaveRule(unsigned int nbirth, unsigned int nsurvival) { m_CaveBirth = nbirth; m_CaveSurvival = nsurvival;}
+
+    bool allowsOverlap() const { return m_AllowOverlap;}
+
+    bool generate(Map *tmap, Random *trng, LevelGenInfo *tinfo = NULL) const;
+};
+
+// generates one level on a worker thread
+class LevelJob: public WorkerJob
+{
+private:
+
+    const LevelGenerator *m_Generator;
+    Map *m_Map;
+    Random m_Random;
+
+public:
+    LevelJob(const LevelGenerator *tgen, Map *tmap, const Random &trng);
+
+    Map *getMap() const { return m_Map;}
+
+    void run();
+};
+
+#endif // CLASS_LEVELGEN
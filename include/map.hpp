@@ -3,6 +3,7 @@
 
 #include <string>
 #include <vector>
+#include <stdint.h>
 
 #ifdef NCURSES
 #include <ncurses.h>
@@ -12,14 +13,21 @@
 
 #include "tools.hpp"
 #include "glyph.hpp"
+#include "scheduler.hpp"
+#include "objectpool.hpp"
+#include "entitystore.hpp"
+#include "symbol.hpp"
 
 #include <tinyxml2.h>
 
 using namespace tinyxml2;
 
 // forward declaration
+class WorldObject;
+class Prefab;
 class Item;
 class Actor;
+class Door;
 
 class Tile
 {
@@ -27,7 +35,7 @@ public:
     Tile();
     ~Tile();
 
-    std::string m_Name;
+    Symbol m_Name;
     glyph m_Glyph;
     int m_ID;
 
@@ -38,19 +46,64 @@ class Map
 {
 private:
 
-    std::vector< std::vector<int> > m_Array;
-    std::vector< Item*> m_Items;
-    std::vector< Actor*> m_Actors;
+    // tiles are stored row-major, index = y*m_Width + x
+    std::vector<int> m_Array;
+    int m_Width;
+    int m_Height;
+
+    // objects owned by the map, hold on to them by handle
+    EntityStore<Item> m_Items;
+    EntityStore<Actor> m_Actors;
+
+    // items that need to be ticked every turn, removed items leave a
+    // stale handle that the next tick drops
+    std::vector<EntityHandle> m_TickItems;
+
+    // map owned actors waiting for their next action
+    Scheduler m_Scheduler;
+    long m_Time;
+
+    // head of the item list for each cell, same layout as m_Array
+    // the newest item in a cell is always first
+    std::vector< Item*> m_ItemCells;
+    void linkItem(Item *titem);
+    void unlinkItem(Item *titem);
+    void rebuildItemCells();
+
+    // actor occupying each cell, same layout as m_Array
+    std::vector< Actor*> m_ActorCells;
+    void occupyCell(Actor *tactor);
+    void vacateCell(Actor *tactor, vector2i tpos);
+
+    // tile definitions used to build the cached cell flags
+    const std::vector<Tile> *m_TileSet;
+
+    // packed bitplanes, one bit per cell (bit index = y*m_Width + x)
+    // combines tile, item and actor flags for each cell
+    std::vector<uint64_t> m_BlocksLight;
+    std::vector<uint64_t> m_BlocksMove;
 
     bool addItem(Item* nitem);
     bool addActor(Actor *nactor);
 
+    // storage for objects spawned on this level, released with the level
+    // objects added from outside (ie. dropped items) stay on the heap
+    ObjectPool<Item> m_ItemPool;
+    ObjectPool<Actor> m_ActorPool;
+    ObjectPool<Door> m_DoorPool;
+
+    bool detachActor(Actor *tactor);
+    void destroyActor(Actor *tactor);
+
 public:
     Map();
     ~Map();
 
     // map tiles
-    vector2i getDimensions() const;
+    vector2i getDimensions() const { return vector2i(m_Width, m_Height);}
+    int getWidth() const { return m_Width;}
+    int getHeight() const { return m_Height;}
+    bool isInBounds(int x, int y) const { return x >= 0 && y >= 0 && x < m_Width && y < m_Height;}
     void clear();
     void resize(unsigned int x, unsigned int y);
     void fill(unsigned int tileindex);
@@ -58,19 +111,74 @@ public:
     int getMapTileIndexAt(vector2i tpos) const;
     bool setTileAt(unsigned int x, unsigned int y, int ttile);
 
+    // unchecked tile access, caller must make sure x,y is in bounds
+    // setTileUnchecked does not update the cell flags, call refreshAllCells() when done
+    int getTileIndexUnchecked(int x, int y) const { return m_Array[y*m_Width + x];}
+    void setTileUnchecked(int x, int y, int ttile) { m_Array[y*m_Width + x] = ttile;}
+
+    // bulk tile writes, clipped to the map
+    // like setTileUnchecked these do not update the cell flags
+    int setTileRow(int x, int y, const int *ttiles, int count);
+    int fillTileRow(int x, int y, int count, int ttile);
+    void fillRect(const recti &trect, int ttile);
+    void copyRegion(const Map *srcmap, const recti &srcrect, int x, int y);
+    void stampPrefab(const Prefab *tprefab, int x, int y);
+    // unchecked, width tiles of row y
+    const int *getTileRow(int y) const { return &m_Array[y*m_Width];}
+
+    // cached cell flags
+    void setTileSet(const std::vector<Tile> *ttiles);
+    void refreshCell(int x, int y);
+    void refreshAllCells();
+    void refreshRect(const recti &trect);
+    bool blocksLightAt(int x, int y) const
+    {
+        if(!isInBounds(x, y)) return true;
+        unsigned int i = unsigned(y*m_Width + x);
+        return (m_BlocksLight[i >> 6] >> (i & 63)) & 1;
+    }
+    bool blocksMoveAt(int x, int y) const
+    {
+        if(!isInBounds(x, y)) return true;
+        unsigned int i = unsigned(y*m_Width + x);
+        return (m_BlocksMove[i >> 6] >> (i & 63)) & 1;
+    }
+    // nearest cell to tpos that does not block movement, false if there is none
+    bool findOpenCell(vector2i tpos, vector2i *found) const;
+
     // map objects
     // map items
-    const std::vector<Item*> *getItems() const { return &m_Items;}
+    // unordered, removing an item moves the last one into its place
+    const std::vector<Item*> *getItems() const { return &m_Items.getObjects();}
+    // NULL if the handle is stale
+    Item *getItem(EntityHandle thandle) const { return m_Items.get(thandle);}
+    // hot fields of map items for bulk passes, same order as getItems()
+    const EntityStore<Item> &getItemStore() const { return m_Items;}
     std::vector<Item*> getItemsAt(int x, int y);
+    Item *getFirstItemAt(int x, int y) const;
+    // spawn a copy of a prototype from this level's pools, NULL if out of bounds
+    Item *createItem(const Item &tproto, int x, int y);
+    // the caller owns the returned item, pooled items are handed back as a heap copy
     Item *removeItemFromMap(Item *titem);
     bool openDoorAt(int x, int y);
 
     // map actors
-    const std::vector<Actor*> *getActors() const { return &m_Actors;}
-    Actor *getActorAt(int x, int y);
+    const std::vector<Actor*> *getActors() const { return &m_Actors.getObjects();}
+    Actor *getActor(EntityHandle thandle) const { return m_Actors.get(thandle);}
+    const EntityStore<Actor> &getActorStore() const { return m_Actors;}
+    Actor *getActorAt(int x, int y) const;
+    Actor *createActor(const Actor &tproto, int x, int y);
+    // for actors the map does not own (ie. the player)
+    bool placeActor(Actor *tactor);
+    // the caller owns the returned actor, pooled actors are handed back as a heap copy
     Actor *removeActorFromMap(Actor *tactor);
 
+    // called by objects on this map when their position or flags change
+    void objectMoved(WorldObject *tobj, vector2i oldpos);
+    void objectChanged(WorldObject *tobj);
+
     void update();
+    long getTime() const { return m_Time;}
 
     void printInfo() const;
 
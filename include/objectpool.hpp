@@ -0,0 +1,133 @@
+#ifndef CLASS_OBJECTPOOL
+#define CLASS_OBJECTPOOL
+
+#include <vector>
+#include <new>
+#include <cstddef>
+
+// typed pool of objects allocated in fixed size chunks
+// objects of one pool sit next to each other in memory, creating one
+// reuses a free slot instead of going to the heap, and releaseAll()
+// destroys everything still alive in one sweep
+template <class T>
+class ObjectPool
+{
+private:
+
+    int m_ChunkSize;
+    std::vector<T*> m_Chunks;
+    std::vector<unsigned char> m_Alive;
+    std::vector<int> m_Free;
+    int m_LiveCount;
+
+    // disable copying, pools own raw memory
+    ObjectPool(const ObjectPool&);
+    ObjectPool &operator=(const ObjectPool&);
+
+    T *getAt(int slot) const { return m_Chunks[slot / m_ChunkSize] + slot % m_ChunkSize;}
+
+    void *allocate(int *slot)
+    {
+        if(m_Free.empty())
+        {
+            int first = int(m_Chunks.size()) * m_ChunkSize;
+
+            T *chunk = static_cast<T*>( ::operator new(sizeof(T) * m_ChunkSize) );
+            m_Chunks.push_back(chunk);
+            m_Alive.resize(m_Chunks.size() * m_ChunkSize, 0);
+
+            // hand out the lowest address first
+            for(int i = m_ChunkSize - 1; i >= 0; i--) m_Free.push_back(first + i);
+        }
+
+        int nslot = m_Free.back();
+        m_Free.pop_back();
+
+        m_Alive[nslot] = 1;
+        m_LiveCount++;
+
+        if(slot) *slot = nslot;
+
+        return getAt(nslot);
+    }
+
+public:
+    ObjectPool(int chunksize = 64)
+    {
+        m_ChunkSize = chunksize > 0 ? chunksize : 1;
+        m_LiveCount = 0;
+    }
+
+    ~ObjectPool()
+    {
+        releaseAll();
+
+        for(int i = 0; i < int(m_Chunks.size()); i++) ::operator delete(m_Chunks[i]);
+    }
+
+    // copy construct a new object in the pool
+    // its slot number is stored in slot, the caller keeps it for destroy()
+    T *create(const T &tproto, int *slot)
+    {
+        void *mem = allocate(slot);
+
+        return new(mem) T(tproto);
+    }
+
+    template <class A>
+    T *create(const T &tproto, A arg, int *slot)
+    {
+        void *mem = allocate(slot);
+
+        return new(mem) T(tproto, arg);
+    }
+
+    void destroy(T *tobj, int slot)
+    {
+        if(!owns(tobj, slot) || !m_Alive[slot]) return;
+
+        tobj->~T();
+
+        m_Alive[slot] = 0;
+        m_Free.push_back(slot);
+        m_LiveCount--;
+    }
+
+    // true if tobj is the object living at slot in this pool
+    bool owns(const T *tobj, int slot) const
+    {
+        if(tobj == NULL || slot < 0 || slot >= int(m_Chunks.size()) * m_ChunkSize) return false;
+
+        return getAt(slot) == tobj;
+    }
+
+    int getLiveCount() const { return m_LiveCount;}
+
+    // destroy every live object, the chunks are kept for reuse
+    void releaseAll()
+    {
+        if(m_LiveCount == 0) return;
+
+        m_Free.clear();
+
+        for(int c = int(m_Chunks.size()) - 1; c >= 0; c--)
+        {
+            for(int i = m_ChunkSize - 1; i >= 0; i--)
+            {
+                int slot = c*m_ChunkSize + i;
+
+                if(m_Alive[slot])
+                {
+                    m_Chunks[c][i].~T();
+                    m_Alive[slot] = 0;
+                }
+
+                m_Free.push_back(slot);
+            }
+        }
+
+        m_LiveCount = 0;
+    }
+};
+
+#endif // CLASS_OBJECTPOOL
@@ -0,0 +1,38 @@
+#ifndef CLASS_PREFAB
+#define CLASS_PREFAB
+
+#include <string>
+#include <vector>
+
+#include <tinyxml2.h>
+
+using namespace tinyxml2;
+
+// hand made block of tiles stamped into a map (vaults, set pieces)
+// masked out cells leave the map underneath untouched
+class Prefab
+{
+public:
+    Prefab();
+    ~Prefab();
+
+    std::string m_Name;
+    int m_Width;
+    int m_Height;
+
+    // row major, m_Width x m_Height
+    std::vector<int> m_Tiles;
+    std::vector<unsigned char> m_Mask;
+
+    const int *getTileRow(int y) const { return &m_Tiles[y*m_Width];}
+    const unsigned char *getMaskRow(int y) const { return &m_Mask[y*m_Width];}
+
+    // rows of characters, # is wall, . is floor, unmapped characters (e.g. 'x') are masked out,
+    // other characters can be mapped with <key><char>c</char><tile>n</tile></key>
+    bool loadFromXMLNode(XMLNode *tnode);
+};
+
+// loads every prefab under <prefabs> in an xml file, returns the count or -1
+int loadPrefabsFromXML(std::string xfile, std::vector<Prefab> *prefabs);
+
+#endif // CLASS_PREFAB
@@ -0,0 +1,48 @@
+#ifndef CLASS_RANDOM
+#define CLASS_RANDOM
+
+#include <stdint.h>
+
+// independent random streams derived from the game seed
+enum E_RNGSTREAM{RNG_GAME, RNG_LEVEL, RNG_TOTAL};
+
+// stream type in the high word, level or sub index in the low word
+inline uint64_t getRandomStreamID(E_RNGSTREAM stype, unsigned int index)
+{
+    return (uint64_t(stype) << 32) | index;
+}
+
+// xoshiro256** generator
+// same sequence on every platform for a given seed, each instance is
+// independent so separate streams can be used from separate threads
+class Random
+{
+private:
+
+    uint64_t m_State[4];
+
+public:
+    Random();
+    Random(uint64_t nseed);
+    Random(uint64_t nseed, uint64_t nstream);
+
+    // seed the state through splitmix64, stream picks an independent sequence
+    void seed(uint64_t nseed, uint64_t nstream = 0);
+
+    uint64_t next();
+
+    // advance 2^128 draws, used to hand out non overlapping sequences
+    void jump();
+    // returns a copy of this generator and jumps past it
+    Random split();
+
+    // uniform in [0, nmax), 0 if nmax <= 0
+    int getInt(int nmax);
+    // uniform in [nmin, nmax)
+    int getRange(int nmin, int nmax);
+    // uniform in [0, 1)
+    double getDouble();
+    bool getBool() { return (next() >> 63) != 0;}
+};
+
+#endif // CLASS_RANDOM
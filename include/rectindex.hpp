@@ -0,0 +1,41 @@
+#ifndef CLASS_RECTINDEX
+#define CLASS_RECTINDEX
+
+#include <vector>
+
+#include "tools.hpp"
+
+// uniform bucket grid of placed rectangles
+// with buckets about the size of the largest rectangle, each rectangle
+// touches at most four buckets and an overlap test only looks at the
+// few rectangles near the query
+class RectIndex
+{
+private:
+
+    int m_Width;
+    int m_Height;
+    int m_BucketSize;
+    int m_BucketsX;
+    int m_BucketsY;
+
+    std::vector<recti> m_Rects;
+    // indices into m_Rects for every bucket a rect touches
+    std::vector< std::vector<int> > m_Buckets;
+
+public:
+    RectIndex();
+    ~RectIndex();
+
+    // area covered and bucket edge length in tiles
+    void reset(int width, int height, int bucketsize);
+    void clear();
+
+    void add(const recti &trect);
+    bool overlaps(const recti &trect) const;
+
+    int getCount() const { return int(m_Rects.size());}
+    const recti &getRect(int index) const { return m_Rects[index];}
+};
+
+#endif // CLASS_RECTINDEX
@@ -0,0 +1,69 @@
+#ifndef CLASS_RENDERER
+#define CLASS_RENDERER
+
+#ifdef NCURSES
+#include <ncurses.h>
+#else
+#include "curses.h"
+#endif
+
+#include <string>
+#include <vector>
+
+#include "tools.hpp"
+
+// forward declaration
+class Display;
+
+// double buffered screen renderer
+// each frame is composed into an in-memory cell buffer (character plus
+// attributes as a chtype) and only the cells that differ from the previous
+// frame are sent to curses
+class Renderer
+{
+private:
+
+    // backend frames are presented to
+    Display *m_Display;
+
+    int m_Width;
+    int m_Height;
+
+    // frame being composed
+    std::vector<chtype> m_BackBuffer;
+    // frame currently on the terminal
+    std::vector<chtype> m_FrontBuffer;
+
+    bool m_FullRedraw;
+
+    vector2i m_Cursor;
+
+    void resize(int nwidth, int nheight);
+
+public:
+    Renderer();
+    ~Renderer();
+
+    void setDisplay(Display *tdisplay);
+
+    int getWidth() const { return m_Width;}
+    int getHeight() const { return m_Height;}
+
+    // start a new frame, matches the buffer size to the display
+    void clear();
+
+    // draw into the frame being composed
+    void put(int x, int y, chtype ch);
+    int print(int x, int y, const std::string &str, chtype attr = A_NORMAL);
+    chtype getAt(int x, int y) const;
+
+    // cursor position after the frame is presented
+    void setCursor(int x, int y);
+
+    // send the changed cells to the display
+    void present();
+
+    // next present() redraws every cell
+    void invalidate();
+};
+#endif // CLASS_RENDERER
@@ -0,0 +1,50 @@
+#ifndef CLASS_SCHEDULER
+#define CLASS_SCHEDULER
+
+#include <vector>
+#include <cstddef>
+
+#include "slotmap.hpp"
+
+// game time is counted in ticks, one player turn at normal speed
+#define TURN_TICKS 100
+// actor speed that acts exactly once per turn
+#define NORMAL_SPEED 100
+
+// priority queue of actors ordered by the tick they next get to act
+// actors are held by handle, entries of actors that left the map are
+// never searched for, they go stale and the owner skips them when popped
+class Scheduler
+{
+private:
+
+    struct Entry
+    {
+        long m_Time;
+        unsigned long m_Order;
+        EntityHandle m_Actor;
+    };
+
+    // min heap on time, ties keep scheduling order
+    std::vector<Entry> m_Heap;
+    unsigned long m_NextOrder;
+
+    static bool later(const Entry &a, const Entry &b);
+
+public:
+    Scheduler();
+    ~Scheduler();
+
+    void schedule(EntityHandle tactor, long ttime);
+    void clear();
+
+    bool empty() const { return m_Heap.empty();}
+    int size() const { return int(m_Heap.size());}
+    long getNextTime() const;
+
+    // removes and returns the next actor if it acts at or before ttime
+    // returns a null handle when nothing is ready
+    EntityHandle popReady(long ttime, long *acttime = NULL);
+};
+
+#endif // CLASS_SCHEDULER
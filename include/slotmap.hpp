@@ -0,0 +1,150 @@
+#ifndef CLASS_SLOTMAP
+#define CLASS_SLOTMAP
+
+#include <vector>
+#include <stdint.h>
+
+// stable reference to an entry in a SlotMap
+// the generation changes every time a slot is reused, so a handle to a
+// removed entry stays detectably stale instead of pointing at a new one
+struct EntityHandle
+{
+    uint32_t m_Index;
+    uint32_t m_Generation;
+
+    EntityHandle() : m_Index(0xFFFFFFFF), m_Generation(0) {};
+    EntityHandle(uint32_t nindex, uint32_t ngeneration) : m_Index(nindex), m_Generation(ngeneration) {};
+
+    bool isNull() const { return m_Index == 0xFFFFFFFF;}
+    bool operator==(const EntityHandle &thandle) const { return m_Index == thandle.m_Index && m_Generation == thandle.m_Generation;}
+    bool operator!=(const EntityHandle &thandle) const { return !(*this == thandle);}
+};
+
+// values kept packed in a dense array, addressed through handles
+// insert, remove and lookup are O(1), removal swaps the last value into
+// the hole so iteration order is not preserved
+template <class T>
+class SlotMap
+{
+private:
+
+    struct Slot
+    {
+        uint32_t m_Dense;
+        uint32_t m_Generation;
+    };
+
+    std::vector<T> m_Dense;
+    std::vector<uint32_t> m_DenseToSlot;
+    std::vector<Slot> m_Slots;
+    std::vector<uint32_t> m_FreeSlots;
+
+public:
+    SlotMap() {};
+    ~SlotMap() {};
+
+    EntityHandle insert(const T &tvalue)
+    {
+        uint32_t slot;
+
+        if(m_FreeSlots.empty())
+        {
+            slot = uint32_t(m_Slots.size());
+
+            Slot nslot;
+            nslot.m_Generation = 0;
+            m_Slots.push_back(nslot);
+        }
+        else
+        {
+            slot = m_FreeSlots.back();
+            m_FreeSlots.pop_back();
+        }
+
+        m_Slots[slot].m_Dense = uint32_t(m_Dense.size());
+        m_Dense.push_back(tvalue);
+        m_DenseToSlot.push_back(slot);
+
+        return EntityHandle(slot, m_Slots[slot].m_Generation);
+    }
+
+    bool contains(const EntityHandle &thandle) const
+    {
+        return thandle.m_Index < m_Slots.size() && m_Slots[thandle.m_Index].m_Generation == thandle.m_Generation &&
+               m_Slots[thandle.m_Index].m_Dense < m_Dense.size() && m_DenseToSlot[ m_Slots[thandle.m_Index].m_Dense] == thandle.m_Index;
+    }
+
+    // position in the dense array, -1 if the handle is stale
+    int getDenseIndex(const EntityHandle &thandle) const
+    {
+        if(!contains(thandle)) return -1;
+
+        return int(m_Slots[thandle.m_Index].m_Dense);
+    }
+
+    // NULL if the handle is stale
+    T *get(const EntityHandle &thandle)
+    {
+        if(!contains(thandle)) return NULL;
+
+        return &m_Dense[ m_Slots[thandle.m_Index].m_Dense];
+    }
+
+    const T *get(const EntityHandle &thandle) const
+    {
+        if(!contains(thandle)) return NULL;
+
+        return &m_Dense[ m_Slots[thandle.m_Index].m_Dense];
+    }
+
+    bool remove(const EntityHandle &thandle)
+    {
+        if(!contains(thandle)) return false;
+
+        uint32_t dense = m_Slots[thandle.m_Index].m_Dense;
+        uint32_t last = uint32_t(m_Dense.size()) - 1;
+
+        // move the last value into the hole
+        if(dense != last)
+        {
+            m_Dense[dense] = m_Dense[last];
+            m_DenseToSlot[dense] = m_DenseToSlot[last];
+            m_Slots[ m_DenseToSlot[dense] ].m_Dense = dense;
+        }
+
+        m_Dense.pop_back();
+        m_DenseToSlot.pop_back();
+
+        m_Slots[thandle.m_Index].m_Generation++;
+        m_FreeSlots.push_back(thandle.m_Index);
+
+        return true;
+    }
+
+    // invalidates every handle
+    void clear()
+    {
+        for(int i = 0; i < int(m_DenseToSlot.size()); i++)
+        {
+            m_Slots[ m_DenseToSlot[i] ].m_Generation++;
+            m_FreeSlots.push_back( m_DenseToSlot[i]);
+        }
+
+        m_Dense.clear();
+        m_DenseToSlot.clear();
+    }
+
+    // dense access for iteration
+    int size() const { return int(m_Dense.size());}
+    bool empty() const { return m_Dense.empty();}
+    T &operator[](int index) { return m_Dense[index];}
+    const T &operator[](int index) const { return m_Dense[index];}
+    const std::vector<T> &getValues() const { return m_Dense;}
+    EntityHandle getHandleAt(int index) const
+    {
+        uint32_t slot = m_DenseToSlot[index];
+        return EntityHandle(slot, m_Slots[slot].m_Generation);
+    }
+};
+
+#endif // CLASS_SLOTMAP
@@ -0,0 +1,65 @@
+#ifndef CLASS_SYMBOL
+#define CLASS_SYMBOL
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <cstddef>
+
+// interned string, every distinct string is stored once in a global table
+// and a symbol is just its index, so symbols compare and copy like ints
+// the table only grows, interning is not thread safe and is done from the
+// main thread (data loading, console)
+class Symbol
+{
+private:
+
+    unsigned int m_ID;
+
+    class Table
+    {
+    private:
+        // strings never move once added
+        std::deque<std::string> m_Strings;
+        std::vector<unsigned int> m_Hashes;
+
+        // open addressing, 0 = empty, otherwise symbol id + 1
+        std::vector<unsigned int> m_Buckets;
+
+        void grow();
+
+    public:
+        Table();
+
+        unsigned int find(const char *str, size_t len, bool add);
+        const std::string &getString(unsigned int id) const { return m_Strings[id];}
+        int getCount() const { return int(m_Strings.size());}
+    };
+
+    static Table &getTable();
+
+    explicit Symbol(unsigned int nid) : m_ID(nid) {};
+
+public:
+    // the empty string
+    Symbol() : m_ID(0) {};
+    Symbol(const std::string &str);
+    Symbol(const char *str);
+    Symbol(const char *str, size_t len);
+
+    // symbol of an existing string without interning it, empty if it was never interned
+    static Symbol lookup(const char *str, size_t len);
+    static int getCount();
+
+    unsigned int getID() const { return m_ID;}
+    bool empty() const { return m_ID == 0;}
+    const std::string &str() const;
+    const char *c_str() const { return str().c_str();}
+
+    bool operator==(const Symbol &tsym) const { return m_ID == tsym.m_ID;}
+    bool operator!=(const Symbol &tsym) const { return m_ID != tsym.m_ID;}
+    // orders by id, not alphabetically
+    bool operator<(const Symbol &tsym) const { return m_ID < tsym.m_ID;}
+};
+
+#endif // CLASS_SYMBOL
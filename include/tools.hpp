@@ -1,6 +1,8 @@
 #ifndef CLASS_TOOLS
 #define CLASS_TOOLS
 
+#include <string>
+
 class vector2i
 {
 public:
@@ -30,4 +32,10 @@ float getDistance(int x1, int y1, int x2, int y2);
 char getIndexChar(int i);
 int getIndexFromChar(char c);
 
+// output for the printInfo() debug dumps, the console installs itself as
+// the printer, without one (ie. in tools) the lines go to stdout
+typedef void (*InfoPrinter)(const std::string &str);
+void setInfoPrinter(InfoPrinter tprinter);
+void printInfoLine(const std::string &str);
+
 #endif // CLASS_TOOLS
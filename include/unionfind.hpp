@@ -0,0 +1,31 @@
+#ifndef CLASS_UNIONFIND
+#define CLASS_UNIONFIND
+
+#include <vector>
+
+// disjoint set forest with union by size and path halving
+class UnionFind
+{
+private:
+
+    std::vector<int> m_Parent;
+    std::vector<int> m_Size;
+
+public:
+    UnionFind();
+    UnionFind(int count);
+    ~UnionFind();
+
+    void reset(int count);
+
+    int find(int a);
+    // returns true if a and b were in different sets
+    bool unite(int a, int b);
+};
+
+// label the 4-connected regions of non zero cells in a width x height grid
+// labels gets a region number from 0 for open cells and -1 for the rest,
+// regions are numbered in scan order, returns the region count
+int labelRegions(const unsigned char *open, int width, int height, std::vector<int> *labels);
+
+#endif // CLASS_UNIONFIND
@@ -0,0 +1,61 @@
+#ifndef CLASS_WORKERPOOL
+#define CLASS_WORKERPOOL
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+// unit of work handed to the pool, the pool does not own jobs
+class WorkerJob
+{
+private:
+    // guarded by the pool mutex
+    bool m_Queued;
+    bool m_Done;
+
+public:
+    WorkerJob() : m_Queued(false), m_Done(false) {};
+    virtual ~WorkerJob() {};
+
+    virtual void run()=0;
+
+    friend class WorkerPool;
+};
+
+// fixed set of threads pulling jobs off a shared queue
+class WorkerPool
+{
+private:
+
+    std::vector<std::thread> m_Threads;
+    std::deque<WorkerJob*> m_Queue;
+    int m_Pending;
+    bool m_Stopping;
+
+    std::mutex m_Mutex;
+    std::condition_variable m_JobReady;
+    std::condition_variable m_JobDone;
+
+    void workerLoop();
+
+public:
+    WorkerPool();
+    ~WorkerPool();
+
+    // 0 threads uses the hardware thread count
+    void start(int nthreads = 0);
+    void stop();
+    int getThreadCount() const { return int(m_Threads.size());}
+
+    // runs inline when the pool has not been started
+    void submit(WorkerJob *tjob);
+
+    bool isDone(WorkerJob *tjob);
+    // block until the job has finished, runs it here if no worker has picked it up
+    void wait(WorkerJob *tjob);
+    void waitAll();
+};
+
+#endif // CLASS_WORKERPOOL
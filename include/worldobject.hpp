@@ -11,56 +11,100 @@
 
 #include "tools.hpp"
 #include "glyph.hpp"
+#include "slotmap.hpp"
+#include "symbol.hpp"
 
 #include <tinyxml2.h>
 
 using namespace tinyxml2;
 
+// forward declaration
+class Map;
+
 enum OBJTYPE{ OBJ_ACTOR, OBJ_ITEM, OBJ_TOTAL};
 
+// definition data shared by a prototype and every object copied from it
+// reference counted, freed when the last object using it goes away
+class ObjectDef
+{
+public:
+    ObjectDef();
+    ObjectDef(const ObjectDef &tdef);
+
+    int m_ID;
+    Symbol m_Name;
+    Symbol m_Article;
+
+    // objects referencing this definition
+    mutable int m_RefCount;
+};
+
 class WorldObject
 {
+private:
+
+    // shared with every copy, copied on write
+    const ObjectDef *m_Def;
+
+    void releaseDef();
+
 protected:
 
-    int m_ID;
+    // definition this object may write to, copied first if it is shared
+    ObjectDef *editDef();
 
-    std::string m_Name;
-    std::string m_Article;
     vector2i m_Position;
 
     glyph m_Glyph;
 
+    // map the object is currently placed on, NULL if not on a map
+    Map *m_Map;
+    // handle in the owning map, null if the map does not own the object
+    EntityHandle m_Handle;
+    // slot in the owning map's pool, -1 if allocated with new
+    int m_PoolSlot;
+
 public:
     WorldObject();
     WorldObject(const WorldObject &tobj);
     virtual ~WorldObject();
+    WorldObject &operator=(const WorldObject &tobj);
     virtual OBJTYPE getType()=0;
 
-    int getID() { return m_ID;}
-    std::string getName() const { return m_Name;}
-    std::string getArticle() const { return m_Article;}
+    int getID() { return m_Def->m_ID;}
+    const std::string &getName() const { return m_Def->m_Name.str();}
+    const std::string &getArticle() const { return m_Def->m_Article.str();}
+    Symbol getNameSymbol() const { return m_Def->m_Name;}
+    Symbol getArticleSymbol() const { return m_Def->m_Article;}
+    const ObjectDef *getDef() const { return m_Def;}
     chtype getIcon() { return m_Glyph.m_Character;}
     vector2i getPosition() { return m_Position;}
     int getColorForeground() { return m_Glyph.m_Color.m_Foreground;}
     int getColorBackground() { return m_Glyph.m_Color.m_Background;}
-    glyph getGlyph() const { return m_Glyph;}
+    const glyph &getGlyph() const { return m_Glyph;}
     bool isWalkable() { return m_Glyph.m_Walkable;}
     bool passesLight() { return m_Glyph.m_PassesLight;}
     bool canPickup() { return m_Glyph.m_CanPickup;}
+    Map *getMap() const { return m_Map;}
+    EntityHandle getHandle() const { return m_Handle;}
 
     void setName(std::string nname, std::string narticle);
-    void setIcon(chtype nicon) {m_Glyph.m_Character = nicon;}
+    void setIcon(chtype nicon);
     void setPosition(int nx, int ny);
     void setPosition(vector2i npos);
     void setColors(int foreground, int background, bool bold);
-    void setWalkable(bool nwalkable) { m_Glyph.m_Walkable = nwalkable;}
-    void setPassesLight(bool nplight) { m_Glyph.m_PassesLight = nplight;}
+    void setWalkable(bool nwalkable);
+    void setPassesLight(bool nplight);
     void setCanPickup(bool npickup) { m_Glyph.m_CanPickup = npickup;}
 
     virtual void update()=0;
+    // objects without behavior are never ticked by the map
+    virtual bool needsUpdate() const { return true;}
     virtual bool loadFromXMLNode(XMLNode *tnode);
     virtual void printInfo() const;
 
+    friend class Map;
+    friend class DataPack;
 };
 
 #endif // CLASS_WORLDOBJECT
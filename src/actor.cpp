@@ -1,12 +1,13 @@
 #include "actor.hpp"
 #include "item.hpp"
-#include "console.hpp"
+#include "scheduler.hpp"
 #include <sstream>
 
 Actor::Actor()
 {
     // set default parameters
     m_LOSRadius = 5;
+    m_Speed = NORMAL_SPEED;
 }
 
 Actor::~Actor()
@@ -19,6 +20,17 @@ bool Actor::addItemToInventory(Item *titem)
     m_Inventory.push_back(titem);
 }
 
+// ticks between two actions
+long Actor::getActionDelay() const
+{
+    if(m_Speed <= 0) return TURN_TICKS * NORMAL_SPEED;
+
+    long delay = long(TURN_TICKS) * NORMAL_SPEED / m_Speed;
+    if(delay < 1) delay = 1;
+
+    return delay;
+}
+
 bool Actor::isAlive()
 {
 
@@ -41,9 +53,7 @@ bool Actor::loadFromXMLNode(XMLNode *tnode)
 
     while(anode != NULL)
     {
-
-        // nothing to process that differs from worldobject load from xml
-
+        if(!strcmp(anode->Value(), "speed")) anode->ToElement()->QueryIntText(&m_Speed);
 
         anode = anode->NextSibling();
     }
@@ -56,15 +66,17 @@ void Actor::printInfo() const
 	// print parent class
 	WorldObject::printInfo();
 
-    Console *console = Console::getInstance();
-
     std::stringstream ss;
     ss << "LOS Radius:" << getLOSRadius();
-    console->print(ss.str() );
+    printInfoLine(ss.str() );
+    ss.str(std::string());
+
+    ss << "Speed:" << getSpeed();
+    printInfoLine(ss.str() );
     ss.str(std::string());
 
     ss << "Inventory:" << m_Inventory.size() << " items.";
-    console->print(ss.str());
+    printInfoLine(ss.str());
     ss.str(std::string());
 
 }
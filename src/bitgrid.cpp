@@ -0,0 +1,184 @@
+#include "bitgrid.hpp"
+#include "random.hpp"
+
+// bit sliced adders, each bit position is an independent cell
+static inline void halfAdd(uint64_t a, uint64_t b, uint64_t *sum, uint64_t *carry)
+{
+    *sum = a ^ b;
+    *carry = a & b;
+}
+
+static inline void fullAdd(uint64_t a, uint64_t b, uint64_t c, uint64_t *sum, uint64_t *carry)
+{
+    uint64_t ab = a ^ b;
+
+    *sum = ab ^ c;
+    *carry = (a & b) | (ab & c);
+}
+
+static inline int popCount(uint64_t x)
+{
+    int count = 0;
+
+    for(; x; count++) x &= x - 1;
+
+    return count;
+}
+
+BitGrid::BitGrid()
+{
+    m_Width = 0;
+    m_Height = 0;
+    m_WordsPerRow = 0;
+    m_PadMask = 0;
+}
+
+BitGrid::~BitGrid()
+{
+
+}
+
+void BitGrid::resize(int width, int height, bool value)
+{
+    m_Width = width > 0 ? width : 0;
+    m_Height = height > 0 ? height : 0;
+    m_WordsPerRow = (m_Width + 63) / 64;
+
+    int usedbits = m_Width & 63;
+    m_PadMask = usedbits ? ~uint64_t(0) << usedbits : 0;
+
+    m_Words.assign(m_WordsPerRow * m_Height, value ? ~uint64_t(0) : 0);
+
+    for(int y = 0; y < m_Height; y++) m_Words[y*m_WordsPerRow + m_WordsPerRow - 1] |= m_PadMask;
+}
+
+void BitGrid::set(int x, int y, bool value)
+{
+    if(x < 0 || y < 0 || x >= m_Width || y >= m_Height) return;
+
+    uint64_t *tword = &m_Words[y*m_WordsPerRow + (x >> 6)];
+    uint64_t bit = uint64_t(1) << (x & 63);
+
+    if(value) *tword |= bit;
+    else *tword &= ~bit;
+}
+
+void BitGrid::fillRandom(Random *trng, float density)
+{
+    // 16 bits of randomness per cell, four cells per draw
+    uint32_t threshold = uint32_t(density * 65536.0f);
+
+    for(int y = 0; y < m_Height; y++)
+    {
+        for(int w = 0; w < m_WordsPerRow; w++)
+        {
+            uint64_t tword = 0;
+
+            for(int b = 0; b < 64; b += 4)
+            {
+                uint64_t r = trng->next();
+
+                for(int n = 0; n < 4; n++)
+                {
+                    if( uint32_t((r >> (n*16)) & 0xFFFF) < threshold) tword |= uint64_t(1) << (b + n);
+                }
+            }
+
+            m_Words[y*m_WordsPerRow + w] = tword;
+        }
+
+        m_Words[y*m_WordsPerRow + m_WordsPerRow - 1] |= m_PadMask;
+    }
+}
+
+void BitGrid::step(unsigned int birth, unsigned int survival)
+{
+    if(m_Words.empty()) return;
+
+    std::vector<uint64_t> next(m_Words.size());
+
+    // rows outside the grid are all set
+    std::vector<uint64_t> outside(m_WordsPerRow, ~uint64_t(0));
+
+    for(int y = 0; y < m_Height; y++)
+    {
+        const uint64_t *above = y > 0 ? &m_Words[(y-1)*m_WordsPerRow] : &outside[0];
+        const uint64_t *row = &m_Words[y*m_WordsPerRow];
+        const uint64_t *below = y < m_Height - 1 ? &m_Words[(y+1)*m_WordsPerRow] : &outside[0];
+
+        for(int w = 0; w < m_WordsPerRow; w++)
+        {
+            const uint64_t *rows[3] = {above, row, below};
+            uint64_t left[3], mid[3], right[3];
+
+            // neighbor columns, shifting in the edge bit of the adjacent words
+            for(int r = 0; r < 3; r++)
+            {
+                uint64_t prev = w > 0 ? rows[r][w-1] : ~uint64_t(0);
+                uint64_t cur = rows[r][w];
+                uint64_t nxt = w < m_WordsPerRow - 1 ? rows[r][w+1] : ~uint64_t(0);
+
+                left[r] = (cur << 1) | (prev >> 63);
+                mid[r] = cur;
+                right[r] = (cur >> 1) | (nxt << 63);
+            }
+
+            // add up the 8 neighbors into a 4 bit count per cell
+            uint64_t s1, c1, s2, c2, s3, c3;
+            fullAdd(left[0], mid[0], right[0], &s1, &c1);
+            fullAdd(left[2], mid[2], right[2], &s2, &c2);
+            halfAdd(left[1], right[1], &s3, &c3);
+
+            uint64_t bit0, c4;
+            fullAdd(s1, s2, s3, &bit0, &c4);
+
+            uint64_t t1, c5, bit1, c6;
+            fullAdd(c1, c2, c3, &t1, &c5);
+            halfAdd(t1, c4, &bit1, &c6);
+
+            uint64_t bit2, bit3;
+            halfAdd(c5, c6, &bit2, &bit3);
+
+            // apply the rule for every neighbor count at once
+            uint64_t cell = mid[1];
+            uint64_t result = 0;
+
+            for(int n = 0; n <= 8; n++)
+            {
+                unsigned int tborn = (birth >> n) & 1;
+                unsigned int tkeep = (survival >> n) & 1;
+                if(!tborn && !tkeep) continue;
+
+                uint64_t match = (n & 1 ? bit0 : ~bit0) & (n & 2 ? bit1 : ~bit1) &
+                                 (n & 4 ? bit2 : ~bit2) & (n & 8 ? bit3 : ~bit3);
+
+                if(tborn) result |= match & ~cell;
+                if(tkeep) result |= match & cell;
+            }
+
+            next[y*m_WordsPerRow + w] = result;
+        }
+
+        next[y*m_WordsPerRow + m_WordsPerRow - 1] |= m_PadMask;
+    }
+
+    m_Words.swap(next);
+}
+
+int BitGrid::countSet() const
+{
+    int count = 0;
+
+    for(int y = 0; y < m_Height; y++)
+    {
+        for(int w = 0; w < m_WordsPerRow; w++)
+        {
+            uint64_t tword = m_Words[y*m_WordsPerRow + w];
+            if(w == m_WordsPerRow - 1) tword &= ~m_PadMask;
+
+            count += popCount(tword);
+        }
+    }
+
+    return count;
+}
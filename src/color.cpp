@@ -2,6 +2,29 @@
 
 using namespace tinyxml2;
 
+// [background][foreground]
+static int colorpairs[MAX_COLORS][MAX_COLORS] = {{0}};
+
+static bool isValidColor(COLOR tcolor)
+{
+    return tcolor.m_Foreground >= 0 && tcolor.m_Background >= 0 &&
+           tcolor.m_Foreground < MAX_COLORS && tcolor.m_Background < MAX_COLORS;
+}
+
+void setColorPair(COLOR tcolor, int pair)
+{
+    if(!isValidColor(tcolor)) return;
+
+    colorpairs[tcolor.m_Background][tcolor.m_Foreground] = pair;
+}
+
+int getColorPair(COLOR tcolor)
+{
+    if(!isValidColor(tcolor)) return 0;
+
+    return colorpairs[tcolor.m_Background][tcolor.m_Foreground];
+}
+
 COLOR loadColorFromXMLNode(XMLNode *tnode)
 {
     COLOR tcol;
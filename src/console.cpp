@@ -3,12 +3,14 @@
 #include <sstream>
 #include <iostream>
 #include <iomanip>
+#include <algorithm>
 
 #include <stdarg.h>
 
 #include "engine.hpp"
 #include "tools.hpp"
 #include "actor.hpp"
+#include "renderer.hpp"
 
 Console *Console::m_Instance = NULL;
 
@@ -25,14 +27,60 @@ Command::Command(int cmdtype, std::string nname, std::string ndesc, void (*nfunc
     m_Function = nfunct;
 }
 
+Command::~Command()
+{
+    for(int i = 0; i < int(m_Children.size()); i++) delete m_Children[i];
+}
+
 bool Command::addCommand(Command *ncmd)
 {
     if(m_Type != C_SUBMENU) return false;
 
     m_Children.push_back(ncmd);
+
+    // keep the table at most half full
+    if(m_Children.size() * 2 > m_ChildTable.size())
+    {
+        m_ChildTable.assign( std::max<size_t>(8, m_ChildTable.size() * 2), (Command*)NULL);
+
+        for(int i = 0; i < int(m_Children.size()); i++) addToChildTable(m_Children[i]);
+    }
+    else addToChildTable(ncmd);
+
     return true;
 }
 
+static inline size_t hashSymbol(Symbol tsym, size_t mask)
+{
+    return size_t(tsym.getID() * 2654435761u) & mask;
+}
+
+void Command::addToChildTable(Command *tcmd)
+{
+    size_t mask = m_ChildTable.size() - 1;
+
+    for(size_t b = hashSymbol(tcmd->m_Name, mask); ; b = (b + 1) & mask)
+    {
+        // first command added with a name wins
+        if(m_ChildTable[b] == NULL) m_ChildTable[b] = tcmd;
+        if(m_ChildTable[b]->m_Name == tcmd->m_Name) return;
+    }
+}
+
+const Command *Command::findChild(Symbol tname) const
+{
+    if(m_ChildTable.empty()) return NULL;
+
+    size_t mask = m_ChildTable.size() - 1;
+
+    for(size_t b = hashSymbol(tname, mask); m_ChildTable[b] != NULL; b = (b + 1) & mask)
+    {
+        if(m_ChildTable[b]->m_Name == tname) return m_ChildTable[b];
+    }
+
+    return NULL;
+}
+
 bool Command::execute(std::vector<std::string> *cmd) const
 {
     if( m_Function != NULL) m_Function(cmd);
@@ -50,7 +98,12 @@ bool Command::hasFunction() const
 //////////////////////////////////////////////////////////
 //
 
-Console::Console()
+static void printInfoToConsole(const std::string &str)
+{
+    Console::getInstance()->print(str);
+}
+
+Console::Console() : m_Root(Command::C_SUBMENU, "", ""), m_Buffer(CONSOLE_LOG_SIZE)
 {
     m_PromptString = ">";
 
@@ -59,6 +112,9 @@ Console::Console()
 
     //initialize commands
     initCommands();
+
+    // debug info from the world objects goes to the console
+    setInfoPrinter(&printInfoToConsole);
 }
 
 Console::~Console()
@@ -79,22 +135,24 @@ Console *Console::getInstance()
 bool Console::initCommands()
 {
     Command *newcmd = new Command(Command::C_CMD, "help", "Print help menu", &ConsoleFunction::printHelp);
-    m_CommandList.push_back(newcmd);
+    m_Root.addCommand(newcmd);
 
     newcmd = new Command(Command::C_SUBMENU, "game", "Game Menu", NULL);
-        newcmd->addCommand(new Command(Command::C_CMD, "new", "start new game", &ConsoleFunction::gameNew));
-    m_CommandList.push_back(newcmd);
+        newcmd->addCommand(new Command(Command::C_CMD, "new", "new [seed] - start new game", &ConsoleFunction::gameNew));
+    m_Root.addCommand(newcmd);
 
     newcmd = new Command(Command::C_SUBMENU, "item", "Item Menu", NULL);
         newcmd->addCommand(new Command(Command::C_CMD, "list", "list items", &ConsoleFunction::printItemList));
         newcmd->addCommand(new Command(Command::C_CMD, "show", "show # - show item info (see list)", &ConsoleFunction::showItemInfo) );
         newcmd->addCommand(new Command(Command::C_CMD, "give", "give item # to player", &ConsoleFunction::giveItemToPlayer) );
-    m_CommandList.push_back(newcmd);
+        newcmd->addCommand(new Command(Command::C_CMD, "spawn", "spawn # x y - create item # on the map", &ConsoleFunction::spawnItem) );
+    m_Root.addCommand(newcmd);
 
     newcmd = new Command(Command::C_SUBMENU, "actor", "Actor Menu", NULL);
         newcmd->addCommand(new Command(Command::C_CMD, "list", "list actors", &ConsoleFunction::printActorList));
         newcmd->addCommand(new Command(Command::C_CMD, "show", "show # - show actor info (see list)", &ConsoleFunction::showActorInfo));
-    m_CommandList.push_back(newcmd);
+        newcmd->addCommand(new Command(Command::C_CMD, "spawn", "spawn # x y - create actor # on the map", &ConsoleFunction::spawnActor));
+    m_Root.addCommand(newcmd);
 
     newcmd = new Command(Command::C_SUBMENU, "map", "Map menu", NULL);
 		newcmd->addCommand(new Command(Command::C_CMD, "show", "Print map info", &ConsoleFunction::printMap) );
@@ -103,27 +161,28 @@ bool Console::initCommands()
 		newcmd->addCommand(new Command(Command::C_CMD, "actors", "Print map actors", &ConsoleFunction::printMapActors) );
 		newcmd->addCommand(new Command(Command::C_CMD, "actor", " show actor #", &ConsoleFunction::showMapActor) );
 		newcmd->addCommand(new Command(Command::C_CMD, "regen", "regenerate current map", &ConsoleFunction::mapRegen) );
+		newcmd->addCommand(new Command(Command::C_CMD, "level", "level # - move the player to level #", &ConsoleFunction::mapLevel) );
 		newcmd->addCommand(new Command(Command::C_CMD, "export", "export map to ascii text file", &ConsoleFunction::mapExport) );
-	m_CommandList.push_back(newcmd);
+	m_Root.addCommand(newcmd);
 
     newcmd = new Command(Command::C_SUBMENU, "player", "Player menu", NULL);
 		newcmd->addCommand(new Command(Command::C_CMD, "show", "Print player info", &ConsoleFunction::printPlayer) );
-	m_CommandList.push_back(newcmd);
+	m_Root.addCommand(newcmd);
 
     newcmd = new Command(Command::C_CMD, "clip", "toggle clipping through walls", &ConsoleFunction::dbgClip);
-    m_CommandList.push_back(newcmd);
+    m_Root.addCommand(newcmd);
 
     newcmd = new Command(Command::C_CMD, "los", "toggle line of sight", &ConsoleFunction::dbgLOS);
-    m_CommandList.push_back(newcmd);
+    m_Root.addCommand(newcmd);
 
     newcmd = new Command(Command::C_CMD, "lighting", "toggle lighting", &ConsoleFunction::dbgLighting);
-    m_CommandList.push_back(newcmd);
+    m_Root.addCommand(newcmd);
 
     newcmd = new Command(Command::C_CMD, "test", "A test", &ConsoleFunction::mytest);
-    m_CommandList.push_back(newcmd);
+    m_Root.addCommand(newcmd);
 
     newcmd = new Command(Command::C_CMD, "colortest", "Show color table", &ConsoleFunction::colortest);
-    m_CommandList.push_back(newcmd);
+    m_Root.addCommand(newcmd);
 
     return true;
 }
@@ -134,26 +193,31 @@ void Console::openConsole()
     std::string command;
     int ch = 0;
 
-    // set curses console environment
-    curs_set(1);
-    echo();
-    scrollok(stdscr, true);
+    Renderer *trender = Engine::getInstance()->getRenderer();
+    Display *tdisplay = Engine::getInstance()->getDisplay();
+
+    // show cursor at the end of the prompt
+    tdisplay->showCursor(true);
 
     // reset command buffer index
     m_CmdBufferIndex = -1;
 
     while(!quit)
     {
-        clear();
-
-        printMessages(&m_Buffer);
+        trender->clear();
 
+        // messages fill the screen, leaving the last line for the prompt
+        recti crect(0, 0, trender->getWidth(), trender->getHeight()-1);
+        int promptline = printMessages(&m_Buffer, trender, &crect);
 
         // print prompt and active input
-        printw("%s%s", m_PromptString.c_str(), command.c_str());
+        int cursorx = trender->print(0, promptline, m_PromptString + command);
+        trender->setCursor(cursorx, promptline);
+
+        trender->present();
 
         // get keystroke
-        ch = getch();
+        ch = tdisplay->getKey();
 
         // handle key strokes and special keys
         if(ch == 27 || ch == 96) quit = true; // escape
@@ -234,47 +298,26 @@ void Console::openConsole()
     }
 }
 
-void Console::print(std::string str, ...)
+void Console::print(const std::string &str)
+{
+    addMessage(&m_Buffer, str);
+}
+
+void Console::print(const char *str, ...)
 {
     va_list v;
     va_start(v, str);
-    va_end(v);
-
     addMessageV(&m_Buffer, str, v);
+    va_end(v);
 }
 
 
-bool Console::parseCommand(std::string tstr)
+bool Console::parseCommand(const std::string &tstr)
 {
-    std::vector<std::string> cmd;
-    size_t spos = 0;
-    int cmdcount = 0;
-
-    if(tstr.empty()) return false;
-
-    // parse each word separated by spaces
-    while(tstr.find_first_of(' ') != std::string::npos)
-    {
-        spos = tstr.find_first_of(' ');
-
-        std::string newcmd = tstr.substr(0, spos);
-
-        cmd.push_back(newcmd);
-
-        tstr.erase(0, spos+1);
-    }
-
-    // if there is content left in the string, add it
-    if(!tstr.empty())
-    {
-        cmd.push_back(tstr);
-    }
-
-    // get count of parsed strings
-    cmdcount = int(cmd.size());
+    if(tokenizeCommand(tstr.data(), tstr.length(), &m_Tokens) == 0) return false;
 
     // sift through words to find last command
-    const Command *tcmd = findCommand(&cmd);
+    const Command *tcmd = findCommand(m_Tokens);
     if(tcmd == NULL) print("Invalid command!  Type 'help'");
     else
     {
@@ -284,60 +327,100 @@ bool Console::parseCommand(std::string tstr)
             ConsoleFunction::printMenuHelp(tcmd);
         }
         // otherwise execute command function
-        else tcmd->execute(&cmd);
+        else
+        {
+            // command functions get the words as strings, reusing the old ones
+            m_Args.resize(m_Tokens.size());
+            for(int i = 0; i < int(m_Tokens.size()); i++) m_Args[i].assign(m_Tokens[i].m_Str, m_Tokens[i].m_Length);
+
+            tcmd->execute(&m_Args);
+        }
     }
 
     return true;
 }
 
-const Command *Console::findCommand( std::vector<std::string> *cmd)
+const Command *Console::findCommand(const std::vector<CommandToken> &tokens) const
 {
     const Command *tcmd = NULL;
-    const Command *cptr = NULL;
-    const std::vector<Command*> *tlist = NULL;
+    const Command *tmenu = &m_Root;
+
+    for(int i = 0; i < int(tokens.size()); i++)
+    {
+        // words that were never interned can not be a command name
+        Symbol tsym = Symbol::lookup(tokens[i].m_Str, tokens[i].m_Length);
+        if(tsym.empty()) break;
 
-    if(cmd == NULL) return tcmd;
-    else if(cmd->empty()) return tcmd;
+        const Command *cptr = tmenu->findChild(tsym);
+        if(cptr == NULL) break;
 
-    int cmdlen = int(cmd->size());
+        tcmd = cptr;
+        tmenu = cptr;
+    }
 
-    tlist = getCommands();
+    return tcmd;
+}
 
-    // check command string
-    for(int i = 0; i < cmdlen; i++)
-    {
-        // if no child list to sift through, break
-        if(tlist == NULL) break;
-        cptr = NULL;
+int tokenizeCommand(const char *str, size_t len, std::vector<CommandToken> *tokens)
+{
+    tokens->clear();
 
-        // check each command in current root list that matches string
-        for(int n = 0; n < int(tlist->size()); n++)
-        {
-            // command found
-            if( (*tlist)[n]->getName() == (*cmd)[i])
-            {
-                cptr = (*tlist)[n];
-                tcmd = cptr;
-                break;
-            }
-        }
+    size_t pos = 0;
 
-        // if command was found, set list to found command's children
-        if(cptr != NULL)
-            tlist = cptr->getChildren();
-        else tlist = NULL;
-    }
+    while(pos < len)
+    {
+        // skip separators
+        while(pos < len && (str[pos] == ' ' || str[pos] == '\t')) pos++;
+        if(pos == len) break;
 
-    if(cptr == NULL) return tcmd;
+        size_t start = pos;
+        while(pos < len && str[pos] != ' ' && str[pos] != '\t') pos++;
 
-    return cptr;
+        CommandToken ttoken;
+        ttoken.m_Str = str + start;
+        ttoken.m_Length = int(pos - start);
+        tokens->push_back(ttoken);
+    }
 
+    return int(tokens->size());
 }
 
 ////////////////////////////////////////////////////////////////
 //
 
-void printMessages(std::vector<ConsoleElement*> *tlist, recti *trect)
+MessageLog::MessageLog(int capacity)
+{
+    m_Entries.resize(capacity > 0 ? capacity : 1);
+    m_First = 0;
+    m_Count = 0;
+}
+
+MessageLog::~MessageLog()
+{
+
+}
+
+ConsoleElement *MessageLog::push()
+{
+    int capacity = int(m_Entries.size());
+
+    if(m_Count < capacity) return &m_Entries[ (m_First + m_Count++) % capacity];
+
+    // full, overwrite the oldest
+    ConsoleElement *tentry = &m_Entries[m_First];
+    m_First = (m_First + 1) % capacity;
+
+    return tentry;
+}
+
+void MessageLog::clear()
+{
+    m_First = 0;
+    m_Count = 0;
+}
+
+// returns the line following the last printed message
+int printMessages(const MessageLog *tlog, Renderer *trender, recti *trect)
 {
     Engine *eptr = Engine::getInstance();
 
@@ -347,119 +430,118 @@ void printMessages(std::vector<ConsoleElement*> *tlist, recti *trect)
     // if a rect is not provided, assume entire screen
     if(trect != NULL) crect = *trect;
 
-    move(crect.y, crect.x);
+    int line = crect.y;
 
     //list starting position
     int i = 0;
-    if( int(tlist->size()) > crect.height)
+    if( tlog->size() > crect.height)
     {
-        i = int(tlist->size()) - crect.height;
+        i = tlog->size() - crect.height;
     }
 
+    // default colors
+    chtype defaultcolor = COLOR_PAIR(eptr->getColorPair(COLOR(COLOR_WHITE, COLOR_BLACK, false)));
+
     // print buffer
-    //for(i = 0; i < int(tlist->size()); i++)
-    for(i; i < int(tlist->size()); i++)
+    for(; i < tlog->size(); i++)
     {
+        const ConsoleElement &tmsg = (*tlog)[i];
+        int x = crect.x;
+        int xend = crect.x + crect.width;
 
-        //reset colors
-        attrset( COLOR_PAIR(eptr->getColorPair(COLOR(COLOR_WHITE, COLOR_BLACK, false))) | A_NORMAL);
-
-        // get local copy of message for printing and formatting
-        ConsoleElement tmsg = *(*tlist)[i];
-        int argnum = 0;
-
-        // evaluate and print each character in message line
-        for(int n = 0; n < tmsg.m_Text.length(); n++)
+        for(int s = 0; s < int(tmsg.m_Spans.size()) && x < xend; s++)
         {
-            // maximum width
-            if(getcurx(stdscr) >= crect.width) break;
+            const MessageSpan &tspan = tmsg.m_Spans[s];
 
-            // formatter found
-            if(tmsg.m_Text[n] == '%')
-            {
-                n++;
+            chtype attr = tspan.m_Pair < 0 ? defaultcolor : COLOR_PAIR(tspan.m_Pair);
+            if(tspan.m_Bold) attr |= A_BOLD;
 
-                // bold identifier found
-                if(tmsg.m_Text[n] == 'b')
-                {
-                    n++;
-                    attron(A_BOLD);
-                }
+            const char *tchar = tmsg.m_Text.data() + tspan.m_Start;
 
-                // if color identifier found, change color
-                // using indexed argument
-                if(tmsg.m_Text[n] == 'c')
-                {
-                    attron( COLOR_PAIR(tmsg.m_Args[argnum]));
-                    argnum++;
-                }
+            for(int n = 0; n < tspan.m_Length && x < xend; n++, x++)
+            {
+                trender->put(x, line, chtype( (unsigned char)tchar[n]) | attr);
             }
-            // else just print a normal character
-            else addch(tmsg.m_Text[n]);
         }
 
-        addch('\n');
+        line++;
     }
 
+    return line;
 }
 
-bool addMessage(std::vector<ConsoleElement*> *tlist, std::string str, ...)
+// parse the message codes into spans, targs is NULL when there are no arguments
+static void parseMessage(MessageLog *tlog, const char *str, va_list *targs)
 {
-    va_list v;
-    va_start(v, str);
-    va_end(v);
-    addMessageV(tlist, str, v);
-}
-
-bool addMessageV(std::vector<ConsoleElement*> *tlist, std::string str, va_list v)
-{
-    // create a console event for text
-    ConsoleElement *newelement = new ConsoleElement;
-    newelement->m_Text = std::string(str);
-
-    // get argument count
-    size_t pos = 0;
-    int argcount = 0;
-
-    // find arguments
-    while(pos != std::string::npos)
+    // reuse the ring entry and the memory it already holds
+    ConsoleElement *tmsg = tlog->push();
+    tmsg->m_Text.clear();
+    tmsg->m_Spans.clear();
+
+    MessageSpan tspan;
+    tspan.m_Start = 0;
+    tspan.m_Length = 0;
+    tspan.m_Pair = -1;
+    tspan.m_Bold = false;
+
+    for(const char *tchar = str; *tchar; tchar++)
     {
-        pos = str.find("%", pos);
+        // new lines are not drawn
+        if(*tchar == '\n') continue;
 
-        // argument found
-        if(pos != std::string::npos)
+        if(*tchar != '%' || tchar[1] == '%')
         {
-            newelement->m_Args.push_back(va_arg(v, int));
-            argcount++;
-            pos++;
+            if(*tchar == '%') tchar++;
+
+            tmsg->m_Text.push_back(*tchar);
+            tspan.m_Length++;
+            continue;
         }
-    }
 
-    // invalid argument count
-    if(argcount != int(newelement->m_Args.size()) )
-    {
-        delete newelement;
-        printw("Invalid argument count! args=%d m_Args size=%d\n", argcount, newelement->m_Args.size());
-        refresh();
-        exit(2);
-        return false;
-    }
+        // formatter found, close the current span
+        if(tspan.m_Length) tmsg->m_Spans.push_back(tspan);
+        tspan.m_Start = int(tmsg->m_Text.length());
+        tspan.m_Length = 0;
 
-    // remove any new line codes
-    pos = 0;
-    while(pos != std::string::npos)
-    {
-        pos = str.find("\n", pos);
+        tchar++;
 
-        // newline found
-        if(pos != std::string::npos)
-        {
-            str.erase(pos);
-            pos++;
-        }
+        // bold stays on for the rest of the message
+        if(*tchar == 'b') tspan.m_Bold = true;
+        // color from the next argument
+        else if(*tchar == 'c') tspan.m_Pair = targs ? va_arg(*targs, int) : -1;
+        else if(*tchar == '\0') break;
     }
 
-    tlist->push_back(newelement);
+    if(tspan.m_Length) tmsg->m_Spans.push_back(tspan);
+}
+
+bool addMessage(MessageLog *tlog, const std::string &str)
+{
+    if(tlog == NULL) return false;
+
+    parseMessage(tlog, str.c_str(), NULL);
+
+    return true;
+}
+
+bool addMessage(MessageLog *tlog, const char *str, ...)
+{
+    va_list v;
+    va_start(v, str);
+    bool result = addMessageV(tlog, str, v);
+    va_end(v);
+
+    return result;
+}
+
+bool addMessageV(MessageLog *tlog, const char *str, va_list v)
+{
+    if(tlog == NULL || str == NULL) return false;
+
+    va_list targs;
+    va_copy(targs, v);
+    parseMessage(tlog, str, &targs);
+    va_end(targs);
 
     return true;
 }
@@ -493,8 +575,8 @@ bool ConsoleFunction::printMenuHelp(const Command *tcmd)
     std::string menutitlesub("%c");
     for(int i = 0; i < menutitle.length()-2; i++) menutitlesub.append("-");
 
-    console->print(menutitle, eptr->getColorPair(COLOR(COLOR_MAGENTA, COLOR_BLACK, false)));
-    console->print(menutitlesub, eptr->getColorPair(COLOR(COLOR_MAGENTA, COLOR_BLACK, false)));
+    console->print(menutitle.c_str(), eptr->getColorPair(COLOR(COLOR_MAGENTA, COLOR_BLACK, false)));
+    console->print(menutitlesub.c_str(), eptr->getColorPair(COLOR(COLOR_MAGENTA, COLOR_BLACK, false)));
 
     for(int i = 0; i < int(cmdlist->size()); i++)
     {
@@ -530,7 +612,11 @@ void ConsoleFunction::gameNew(std::vector<std::string> *cmd)
     Console *console = Console::getInstance();
     Engine *eptr = Engine::getInstance();
 
-    eptr->newGame();
+    // optional seed to replay a previous game
+    uint64_t nseed = 0;
+    if(cmd->size() >= 3) nseed = strtoull( (*cmd)[2].c_str(), NULL, 10);
+
+    eptr->newGame(nseed);
 }
 
 void ConsoleFunction::printItemList(std::vector<std::string> *cmd)
@@ -624,6 +710,46 @@ void ConsoleFunction::giveItemToPlayer(std::vector<std::string> *cmd)
     console->print(ss.str());
 }
 
+void ConsoleFunction::spawnItem(std::vector<std::string> *cmd)
+{
+    Console *console = Console::getInstance();
+    Engine *eptr = Engine::getInstance();
+
+    int cmdlen = int(cmd->size());
+    int itemnum = -1;
+
+    const std::vector<Item*> *ilist = eptr->getItemList();
+
+    // invalid parameters
+    if(cmdlen != 5)
+    {
+        console->print("Invalid parameters!");
+        return;
+    }
+
+    // item number out of range
+    itemnum = atoi( (*cmd)[2].c_str());
+    if(itemnum < 0 || itemnum >= int(ilist->size()) )
+    {
+        console->print("Item #" + (*cmd)[2] + " out of range!");
+        return;
+    }
+
+    int x = atoi( (*cmd)[3].c_str());
+    int y = atoi( (*cmd)[4].c_str());
+
+    Item *newitem = eptr->newItem(itemnum, eptr->m_Levels[eptr->m_CurrentLevel], x, y);
+    if(newitem == NULL)
+    {
+        console->print("Position out of bounds!");
+        return;
+    }
+
+    std::stringstream ss;
+    ss << newitem->getName() << " spawned at " << x << "," << y;
+    console->print(ss.str());
+}
+
 void ConsoleFunction::printActorList(std::vector<std::string> *cmd)
 {
     Console *console = Console::getInstance();
@@ -668,6 +794,54 @@ void ConsoleFunction::showActorInfo(std::vector<std::string> *cmd)
     (*alist)[anum]->printInfo();
 }
 
+void ConsoleFunction::spawnActor(std::vector<std::string> *cmd)
+{
+    Console *console = Console::getInstance();
+    Engine *eptr = Engine::getInstance();
+
+    int cmdlen = int(cmd->size());
+    int anum = -1;
+
+    const std::vector<Actor*> *alist = eptr->getActorList();
+
+    // invalid parameters
+    if(cmdlen != 5)
+    {
+        console->print("Invalid parameters!");
+        return;
+    }
+
+    // actor number out of range
+    anum = atoi( (*cmd)[2].c_str());
+    if(anum < 0 || anum >= int(alist->size()) )
+    {
+        console->print("Actor #" + (*cmd)[2] + " out of range!");
+        return;
+    }
+
+    int x = atoi( (*cmd)[3].c_str());
+    int y = atoi( (*cmd)[4].c_str());
+    Map *tlevel = eptr->m_Levels[eptr->m_CurrentLevel];
+
+    // one actor per cell
+    if(tlevel->getActorAt(x, y))
+    {
+        console->print("Position is occupied!");
+        return;
+    }
+
+    Actor *newactor = eptr->newActor(anum, tlevel, x, y);
+    if(newactor == NULL)
+    {
+        console->print("Position out of bounds!");
+        return;
+    }
+
+    std::stringstream ss;
+    ss << newactor->getName() << " spawned at " << x << "," << y;
+    console->print(ss.str());
+}
+
 void ConsoleFunction::printMap(std::vector<std::string> *cmd)
 {
     Engine *eptr = Engine::getInstance();
@@ -806,7 +980,42 @@ void ConsoleFunction::mapRegen(std::vector<std::string> *cmd)
 
     console->print("Regenerating map...");
 
-    eptr->generateLevel(eptr->m_Levels[eptr->m_CurrentLevel]);
+    // draw from the game stream so regens are reproducible from the seed
+    Map *tmap = eptr->m_Levels[eptr->m_CurrentLevel];
+    Random levelrng = eptr->m_Random.split();
+    eptr->generateLevel(tmap, &levelrng);
+
+    // clearing the map removes the player from it, put them back
+    tmap->placeActor(eptr->m_Player);
+}
+
+void ConsoleFunction::mapLevel(std::vector<std::string> *cmd)
+{
+    Console *console = Console::getInstance();
+    Engine *eptr = Engine::getInstance();
+
+    // invalid parameters
+    if(int(cmd->size()) != 3)
+    {
+        console->print("Invalid parameters!");
+        return;
+    }
+
+    // levels are numbered from 1 for the player
+    int level = atoi( (*cmd)[2].c_str()) - 1;
+    if(level < 0)
+    {
+        console->print("Level #" + (*cmd)[2] + " out of range!");
+        return;
+    }
+
+    if(level == eptr->m_CurrentLevel)
+    {
+        console->print("Already on that level.");
+        return;
+    }
+
+    if(!eptr->changeLevel(level)) console->print("Level #" + (*cmd)[2] + " has no room for the player!");
 }
 
 void ConsoleFunction::colortest(std::vector<std::string> *cmd)
@@ -827,7 +1036,7 @@ void ConsoleFunction::colortest(std::vector<std::string> *cmd)
 
             css << "%c" << std::setfill('0') << std::setw(2) << colorpair;
 
-            console->print(css.str(), eptr->getColorPair(COLOR(n, i, false)));
+            console->print(css.str().c_str(), eptr->getColorPair(COLOR(n, i, false)));
         }
     }
 }
@@ -0,0 +1,380 @@
+#include "datapack.hpp"
+#include "map.hpp"
+#include "item.hpp"
+#include "actor.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <stdint.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <cstdio>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+// pack layout
+// header, tile records, item records, actor records, string table
+// strings are stored as offsets into the null terminated string table
+
+struct PackHeader
+{
+    char m_Magic[4];
+    uint32_t m_Version;
+    uint32_t m_TileCount;
+    uint32_t m_ItemCount;
+    uint32_t m_ActorCount;
+    uint32_t m_StringsSize;
+};
+
+struct PackGlyph
+{
+    uint32_t m_Character;
+    int32_t m_Foreground;
+    int32_t m_Background;
+    uint8_t m_Bold;
+    uint8_t m_Walkable;
+    uint8_t m_PassesLight;
+    uint8_t m_CanPickup;
+};
+
+struct PackTile
+{
+    int32_t m_ID;
+    uint32_t m_Name;
+    PackGlyph m_Glyph;
+};
+
+struct PackObject
+{
+    int32_t m_ID;
+    uint32_t m_Name;
+    uint32_t m_Article;
+    PackGlyph m_Glyph;
+};
+
+struct PackItem
+{
+    PackObject m_Object;
+    float m_Value;
+    float m_Weight;
+    uint32_t m_Door;
+};
+
+struct PackActor
+{
+    PackObject m_Object;
+    int32_t m_Speed;
+};
+
+static const char PACK_MAGIC[4] = {'J','P','A','K'};
+
+/////////////////////////////////////////////////////////
+// read only view of a whole file
+
+class PackFile
+{
+private:
+    const char *m_Data;
+    size_t m_Size;
+
+#ifdef _WIN32
+    std::vector<char> m_Buffer;
+#endif
+
+public:
+    PackFile() : m_Data(NULL), m_Size(0) {};
+    ~PackFile() { close();}
+
+    bool open(std::string fname);
+    void close();
+
+    const char *getData() const { return m_Data;}
+    size_t getSize() const { return m_Size;}
+};
+
+#ifdef _WIN32
+bool PackFile::open(std::string fname)
+{
+    std::ifstream pfile(fname.c_str(), std::ios::binary);
+    if(!pfile.is_open()) return false;
+
+    pfile.seekg(0, std::ios::end);
+    m_Buffer.resize( size_t(pfile.tellg()) );
+    pfile.seekg(0, std::ios::beg);
+    if(!m_Buffer.empty()) pfile.read(&m_Buffer[0], m_Buffer.size());
+
+    m_Data = m_Buffer.empty() ? NULL : &m_Buffer[0];
+    m_Size = m_Buffer.size();
+
+    return pfile.good() || pfile.eof();
+}
+
+void PackFile::close()
+{
+    m_Buffer.clear();
+    m_Data = NULL;
+    m_Size = 0;
+}
+#else
+bool PackFile::open(std::string fname)
+{
+    int fd = ::open(fname.c_str(), O_RDONLY);
+    if(fd < 0) return false;
+
+    struct stat fstats;
+    if(fstat(fd, &fstats) != 0 || fstats.st_size <= 0)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    void *tdata = mmap(NULL, size_t(fstats.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+
+    if(tdata == MAP_FAILED) return false;
+
+    m_Data = static_cast<const char*>(tdata);
+    m_Size = size_t(fstats.st_size);
+
+    return true;
+}
+
+void PackFile::close()
+{
+    if(m_Data) munmap( const_cast<char*>(m_Data), m_Size);
+
+    m_Data = NULL;
+    m_Size = 0;
+}
+#endif
+
+/////////////////////////////////////////////////////////
+// helpers
+
+static bool getModifiedTime(std::string fname, time_t *mtime)
+{
+    struct stat fstats;
+
+    if(stat(fname.c_str(), &fstats) != 0) return false;
+
+    *mtime = fstats.st_mtime;
+    return true;
+}
+
+static uint32_t addString(std::vector<char> *strings, const std::string &str)
+{
+    uint32_t offset = uint32_t(strings->size());
+
+    strings->insert(strings->end(), str.begin(), str.end());
+    strings->push_back('\0');
+
+    return offset;
+}
+
+static void packGlyph(const glyph &tglyph, PackGlyph *pglyph)
+{
+    pglyph->m_Character = uint32_t(tglyph.m_Character);
+    pglyph->m_Foreground = tglyph.m_Color.m_Foreground;
+    pglyph->m_Background = tglyph.m_Color.m_Background;
+    pglyph->m_Bold = tglyph.m_Color.m_Bold;
+    pglyph->m_Walkable = tglyph.m_Walkable;
+    pglyph->m_PassesLight = tglyph.m_PassesLight;
+    pglyph->m_CanPickup = tglyph.m_CanPickup;
+}
+
+static void unpackGlyph(const PackGlyph &pglyph, glyph *tglyph)
+{
+    tglyph->m_Character = chtype(pglyph.m_Character);
+    tglyph->m_Color = COLOR(pglyph.m_Foreground, pglyph.m_Background, pglyph.m_Bold != 0);
+    tglyph->m_Walkable = pglyph.m_Walkable != 0;
+    tglyph->m_PassesLight = pglyph.m_PassesLight != 0;
+    tglyph->m_CanPickup = pglyph.m_CanPickup != 0;
+
+    tglyph->resolve();
+}
+
+void DataPack::packObject(const WorldObject &tobj, std::vector<char> *strings, PackObject *pobj)
+{
+    const ObjectDef *tdef = tobj.getDef();
+
+    pobj->m_ID = tdef->m_ID;
+    pobj->m_Name = addString(strings, tdef->m_Name.str());
+    pobj->m_Article = addString(strings, tdef->m_Article.str());
+    packGlyph(tobj.m_Glyph, &pobj->m_Glyph);
+}
+
+void DataPack::unpackObject(const PackObject &pobj, const char *strings, WorldObject *tobj)
+{
+    ObjectDef *tdef = tobj->editDef();
+
+    tdef->m_ID = pobj.m_ID;
+    tdef->m_Name = strings + pobj.m_Name;
+    tdef->m_Article = strings + pobj.m_Article;
+    unpackGlyph(pobj.m_Glyph, &tobj->m_Glyph);
+}
+
+/////////////////////////////////////////////////////////
+//
+
+bool DataPack::isUpToDate(std::string packfile, const std::vector<std::string> &sources)
+{
+    time_t packtime = 0;
+    if(!getModifiedTime(packfile, &packtime)) return false;
+
+    // pack is stale if any existing source is as new, mtimes only have one
+    // second resolution so an edit in the same second as the pack counts
+    for(int i = 0; i < int(sources.size()); i++)
+    {
+        time_t srctime = 0;
+
+        if(getModifiedTime(sources[i], &srctime) && srctime >= packtime) return false;
+    }
+
+    return true;
+}
+
+bool DataPack::write(std::string packfile, const std::vector<Tile> &tiles, const std::vector<Item*> &items, const std::vector<Actor*> &actors)
+{
+    std::vector<char> strings;
+    std::vector<PackTile> ptiles(tiles.size());
+    std::vector<PackItem> pitems(items.size());
+    std::vector<PackActor> pactors(actors.size());
+
+    for(int i = 0; i < int(tiles.size()); i++)
+    {
+        ptiles[i].m_ID = tiles[i].m_ID;
+        ptiles[i].m_Name = addString(&strings, tiles[i].m_Name.str());
+        packGlyph(tiles[i].m_Glyph, &ptiles[i].m_Glyph);
+    }
+
+    for(int i = 0; i < int(items.size()); i++)
+    {
+        packObject(*items[i], &strings, &pitems[i].m_Object);
+        pitems[i].m_Value = items[i]->m_Value;
+        pitems[i].m_Weight = items[i]->m_Weight;
+        pitems[i].m_Door = items[i]->m_Door ? 1 : 0;
+    }
+
+    for(int i = 0; i < int(actors.size()); i++)
+    {
+        packObject(*actors[i], &strings, &pactors[i].m_Object);
+        pactors[i].m_Speed = actors[i]->m_Speed;
+    }
+
+    PackHeader header;
+    memcpy(header.m_Magic, PACK_MAGIC, 4);
+    header.m_Version = DATAPACK_VERSION;
+    header.m_TileCount = uint32_t(ptiles.size());
+    header.m_ItemCount = uint32_t(pitems.size());
+    header.m_ActorCount = uint32_t(pactors.size());
+    header.m_StringsSize = uint32_t(strings.size());
+
+    std::ofstream pfile(packfile.c_str(), std::ios::binary | std::ios::trunc);
+    if(!pfile.is_open()) return false;
+
+    pfile.write( reinterpret_cast<const char*>(&header), sizeof(header));
+    if(!ptiles.empty()) pfile.write( reinterpret_cast<const char*>(&ptiles[0]), sizeof(PackTile)*ptiles.size());
+    if(!pitems.empty()) pfile.write( reinterpret_cast<const char*>(&pitems[0]), sizeof(PackItem)*pitems.size());
+    if(!pactors.empty()) pfile.write( reinterpret_cast<const char*>(&pactors[0]), sizeof(PackActor)*pactors.size());
+    if(!strings.empty()) pfile.write( &strings[0], strings.size());
+
+    return pfile.good();
+}
+
+bool DataPack::read(std::string packfile, std::vector<Tile> *tiles, std::vector<Item*> *items, std::vector<Actor*> *actors)
+{
+    PackFile pfile;
+    if(!pfile.open(packfile)) return false;
+
+    const char *data = pfile.getData();
+    size_t size = pfile.getSize();
+
+    // validate the whole pack before touching the tables
+    PackHeader header;
+    if(size < sizeof(header)) return false;
+    memcpy(&header, data, sizeof(header));
+
+    if(memcmp(header.m_Magic, PACK_MAGIC, 4) || header.m_Version != DATAPACK_VERSION) return false;
+
+    size_t tileofs = sizeof(header);
+    size_t itemofs = tileofs + sizeof(PackTile) * size_t(header.m_TileCount);
+    size_t actorofs = itemofs + sizeof(PackItem) * size_t(header.m_ItemCount);
+    size_t stringofs = actorofs + sizeof(PackActor) * size_t(header.m_ActorCount);
+
+    if(stringofs + header.m_StringsSize != size) return false;
+    if(header.m_StringsSize == 0 || data[size-1] != '\0') return false;
+
+    const char *strings = data + stringofs;
+    uint32_t strsize = header.m_StringsSize;
+
+    for(uint32_t i = 0; i < header.m_TileCount; i++)
+    {
+        PackTile ptile;
+        memcpy(&ptile, data + tileofs + i*sizeof(PackTile), sizeof(ptile));
+        if(ptile.m_Name >= strsize) return false;
+    }
+    for(uint32_t i = 0; i < header.m_ItemCount; i++)
+    {
+        PackItem pitem;
+        memcpy(&pitem, data + itemofs + i*sizeof(PackItem), sizeof(pitem));
+        if(pitem.m_Object.m_Name >= strsize || pitem.m_Object.m_Article >= strsize) return false;
+    }
+    for(uint32_t i = 0; i < header.m_ActorCount; i++)
+    {
+        PackActor pactor;
+        memcpy(&pactor, data + actorofs + i*sizeof(PackActor), sizeof(pactor));
+        if(pactor.m_Object.m_Name >= strsize || pactor.m_Object.m_Article >= strsize) return false;
+    }
+
+    // tiles
+    tiles->reserve(tiles->size() + header.m_TileCount);
+    for(uint32_t i = 0; i < header.m_TileCount; i++)
+    {
+        PackTile ptile;
+        memcpy(&ptile, data + tileofs + i*sizeof(PackTile), sizeof(ptile));
+
+        tiles->push_back(Tile());
+        tiles->back().m_ID = ptile.m_ID;
+        tiles->back().m_Name = strings + ptile.m_Name;
+        unpackGlyph(ptile.m_Glyph, &tiles->back().m_Glyph);
+    }
+
+    // items
+    items->reserve(items->size() + header.m_ItemCount);
+    for(uint32_t i = 0; i < header.m_ItemCount; i++)
+    {
+        PackItem pitem;
+        memcpy(&pitem, data + itemofs + i*sizeof(PackItem), sizeof(pitem));
+
+        Item *nitem = new Item;
+        unpackObject(pitem.m_Object, strings, nitem);
+        nitem->m_Value = pitem.m_Value;
+        nitem->m_Weight = pitem.m_Weight;
+
+        // door attaches itself to the item
+        if(pitem.m_Door) new Door(nitem);
+
+        items->push_back(nitem);
+    }
+
+    // actors
+    actors->reserve(actors->size() + header.m_ActorCount);
+    for(uint32_t i = 0; i < header.m_ActorCount; i++)
+    {
+        PackActor pactor;
+        memcpy(&pactor, data + actorofs + i*sizeof(PackActor), sizeof(pactor));
+
+        Actor *nactor = new Actor;
+        unpackObject(pactor.m_Object, strings, nactor);
+        nactor->m_Speed = pactor.m_Speed;
+
+        actors->push_back(nactor);
+    }
+
+    return true;
+}
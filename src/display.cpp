@@ -0,0 +1,207 @@
+#include "display.hpp"
+#include <fstream>
+#include <iterator>
+
+//////////////////////////////////////////////////////////
+//
+
+CursesDisplay::CursesDisplay()
+{
+    m_Initialized = false;
+}
+
+CursesDisplay::~CursesDisplay()
+{
+    shutdown();
+}
+
+bool CursesDisplay::init()
+{
+    if(m_Initialized) return false;
+
+    // initialize screen
+    initscr();
+
+    // allow extended keys
+    keypad(stdscr, TRUE);
+
+    // input is drawn by the engine, do not echo keys
+    noecho();
+
+    // disable screen scrolling
+    scrollok(stdscr, false);
+
+    // color init
+    start_color();
+
+    m_Initialized = true;
+    return true;
+}
+
+void CursesDisplay::shutdown()
+{
+    if(!m_Initialized) return;
+
+    // shutdown curses
+    echo();
+    curs_set(1);
+    clear();
+    endwin();
+
+    m_Initialized = false;
+}
+
+bool CursesDisplay::initColorPair(int pair, int foreground, int background)
+{
+    return init_pair(pair, foreground, background) != ERR;
+}
+
+int CursesDisplay::getWidth() const
+{
+    return getmaxx(stdscr);
+}
+
+int CursesDisplay::getHeight() const
+{
+    return getmaxy(stdscr);
+}
+
+void CursesDisplay::clearScreen()
+{
+    erase();
+}
+
+void CursesDisplay::putCell(int x, int y, chtype ch)
+{
+    mvaddch(y, x, ch);
+}
+
+void CursesDisplay::setCursor(int x, int y)
+{
+    move(y, x);
+}
+
+void CursesDisplay::showCursor(bool show)
+{
+    curs_set(show ? 1 : 0);
+}
+
+void CursesDisplay::flush()
+{
+    refresh();
+}
+
+int CursesDisplay::getKey()
+{
+    return getch();
+}
+
+//////////////////////////////////////////////////////////
+//
+
+HeadlessDisplay::HeadlessDisplay(int nwidth, int nheight)
+{
+    m_Width = nwidth;
+    m_Height = nheight;
+
+    m_Screen.assign( size_t(m_Width) * size_t(m_Height), chtype(' '));
+
+    m_FrameCount = 0;
+    m_KeyCount = 0;
+
+    m_FrameLog = NULL;
+}
+
+HeadlessDisplay::~HeadlessDisplay()
+{
+
+}
+
+void HeadlessDisplay::clearScreen()
+{
+    std::fill(m_Screen.begin(), m_Screen.end(), chtype(' '));
+}
+
+void HeadlessDisplay::putCell(int x, int y, chtype ch)
+{
+    if(x < 0 || y < 0 || x >= m_Width || y >= m_Height) return;
+
+    m_Screen[y*m_Width + x] = ch;
+}
+
+void HeadlessDisplay::flush()
+{
+    m_FrameCount++;
+
+    if(m_FrameLog)
+    {
+        *m_FrameLog << "frame " << m_FrameCount << "\n" << getScreenText();
+    }
+}
+
+int HeadlessDisplay::getKey()
+{
+    // script finished, back out of everything
+    if(m_Keys.empty()) return 27;
+
+    int key = m_Keys.front();
+    m_Keys.pop_front();
+    m_KeyCount++;
+
+    return key;
+}
+
+void HeadlessDisplay::pushKey(int key)
+{
+    m_Keys.push_back(key);
+}
+
+void HeadlessDisplay::pushKeys(const std::string &keys)
+{
+    for(int i = 0; i < int(keys.length()); i++)
+    {
+        // enter is delivered as line feed, like curses does
+        if(keys[i] == '\r') continue;
+
+        pushKey( int( (unsigned char)keys[i]) );
+    }
+}
+
+bool HeadlessDisplay::loadKeys(std::string fname)
+{
+    std::ifstream kfile(fname.c_str(), std::ios::binary);
+    if(!kfile.is_open()) return false;
+
+    std::string keys( (std::istreambuf_iterator<char>(kfile)), std::istreambuf_iterator<char>());
+    pushKeys(keys);
+
+    return true;
+}
+
+chtype HeadlessDisplay::getCell(int x, int y) const
+{
+    if(x < 0 || y < 0 || x >= m_Width || y >= m_Height) return chtype(' ');
+
+    return m_Screen[y*m_Width + x];
+}
+
+std::string HeadlessDisplay::getScreenText() const
+{
+    std::string text;
+    text.reserve( (m_Width+1) * m_Height);
+
+    for(int i = 0; i < m_Height; i++)
+    {
+        for(int n = 0; n < m_Width; n++)
+        {
+            chtype ch = m_Screen[i*m_Width + n] & A_CHARTEXT;
+
+            // anything outside printable ascii is shown as '#'
+            if(ch < 32 || ch > 126) text.push_back('#');
+            else text.push_back(char(ch));
+        }
+        text.push_back('\n');
+    }
+
+    return text;
+}
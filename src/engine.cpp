@@ -1,9 +1,11 @@
 #include "engine.hpp"
 #include "actor.hpp"
-#include <cmath>
+#include "datapack.hpp"
+#include <algorithm>
 #include <sstream>
 #include <fstream>
 #include <iostream>
+#include <chrono>
 
 using namespace tinyxml2;
 
@@ -13,6 +15,13 @@ Engine::Engine()
 {
     m_Player = NULL;
     m_Console = NULL;
+    m_Seed = 0;
+    m_NextLevelJob = NULL;
+    m_NextLevel = -1;
+    m_Display = NULL;
+    m_PlayerMoveCount = 0;
+    m_StartupTime = 0;
+    m_MainLoopTime = 0;
 
     //configure debug
     m_DebugFlags.resize(DBG_TOTAL);
@@ -26,11 +35,12 @@ Engine::~Engine()
 {
     delete m_Player;
 
-    // shutdown curses
-    echo();
-    curs_set(1);
-    clear();
-    endwin();
+    // shutdown display
+    if(m_Display)
+    {
+        m_Display->shutdown();
+        delete m_Display;
+    }
 
 }
 
@@ -44,10 +54,26 @@ Engine *Engine::getInstance()
     return m_Instance;
 }
 
+void Engine::setDisplay(Display *tdisplay)
+{
+    if(m_Display == tdisplay) return;
+
+    if(m_Display)
+    {
+        m_Display->shutdown();
+        delete m_Display;
+    }
+
+    m_Display = tdisplay;
+    m_Renderer.setDisplay(m_Display);
+}
+
 void Engine::start()
 {
+    std::chrono::steady_clock::time_point starttime = std::chrono::steady_clock::now();
+
     // init subsystem
-    initCurses();
+    initDisplay();
     initConsole();
     if(ENABLE_COLOR) initColors();
 
@@ -57,27 +83,38 @@ void Engine::start()
     //initItems();
     //initActors();
 
+    m_Workers.start();
+
     newGame();
 
+    std::chrono::steady_clock::time_point looptime = std::chrono::steady_clock::now();
+    m_StartupTime = std::chrono::duration<double>(looptime - starttime).count();
+
     mainLoop();
+
+    m_MainLoopTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - looptime).count();
+
+    m_Workers.stop();
+
+    // give the terminal back
+    m_Display->shutdown();
 }
 
-bool Engine::initCurses()
+bool Engine::initDisplay()
 {
     static bool initialized = false;
     if(initialized) return false;
 
-    // initialize screen
-    initscr();
+    // use the terminal unless another backend was provided
+    if(m_Display == NULL) setDisplay(new CursesDisplay);
 
-    // allow extended keys
-    keypad(stdscr, TRUE);
+    m_Display->init();
 
     initialized = true;
     return true;
 }
 
-// console must initialize after curses init
+// console must initialize after display init
 bool Engine::initConsole()
 {
     m_Console = Console::getInstance();
@@ -92,20 +129,15 @@ bool Engine::initColors()
 
     if(initialized) return false;
 
-    // color init
-    start_color();
-
     // create color pairs in color table
     for(int i = 0; i < MAX_COLORS; i++)
     {
-        m_ColorTable.resize( m_ColorTable.size() + 1);
-
         for(int n = 0; n < MAX_COLORS; n++)
         {
             int colorpair = ( i * MAX_COLORS) + n;
 
-            init_pair(colorpair, n, i);
-            m_ColorTable[i].push_back( colorpair);
+            m_Display->initColorPair(colorpair, n, i);
+            setColorPair(COLOR(n, i, false), colorpair);
 
         }
     }
@@ -117,15 +149,43 @@ bool Engine::initColors()
 
 bool Engine::initData()
 {
-    // load tile data
-    if(!processXML(TILES_XML)) return false;
+    std::vector<std::string> sources;
+    sources.push_back(TILES_XML);
+    sources.push_back(ITEMS_XML);
+    sources.push_back(ACTORS_XML);
+
+    // use the compiled data pack unless the xml has changed since it was built
+    if(DataPack::isUpToDate(DATA_PACK, sources) && DataPack::read(DATA_PACK, &m_Tiles, &m_Items, &m_Actors))
+    {
+        std::stringstream pss;
+        pss << "Loaded " << m_Tiles.size() << " tiles, " << m_Items.size() << " items, " << m_Actors.size() << " actors from " << DATA_PACK;
+        m_Console->print(pss.str());
+    }
+    else
+    {
+        // load tile data
+        if(!processXML(TILES_XML)) return false;
+
+        // load item data
+        if(!processXML(ITEMS_XML)) return false;
+
+        // load actor data
+        if(!processXML(ACTORS_XML)) return false;
 
-    // load item data
-    if(!processXML(ITEMS_XML)) return false;
-    // load actor data
+        // rebuild the pack for next time
+        if(!DataPack::write(DATA_PACK, m_Tiles, m_Items, m_Actors))
+            m_Console->print(std::string("Unable to write data pack: ") + DATA_PACK);
+    }
 
-    // load actor data
-    if(!processXML(ACTORS_XML)) return false;
+    // prefabs are optional
+    int prefabcount = loadPrefabsFromXML(PREFABS_XML, &m_Prefabs);
+    if(prefabcount > 0)
+    {
+        std::stringstream pss;
+        pss << prefabcount << " prefabs loaded from xml.";
+        m_Console->print(pss.str());
+    }
+    m_LevelGen.setPrefabs(&m_Prefabs);
 
     // if no tiles are provided, create default tile
     if(m_Tiles.empty())
@@ -134,6 +194,7 @@ bool Engine::initData()
         Tile newtile;
         newtile.m_Glyph.m_Character = '!';
         newtile.m_Glyph.m_Walkable = false;
+        newtile.m_Glyph.resolve();
         newtile.m_Name = "NO TILE!\n";
         m_Tiles.push_back(newtile);
 
@@ -234,13 +295,19 @@ void Engine::clearGame()
     m_Console->print("Clearing game data...");
 
     // clear player data
-    if(m_Player != NULL) delete m_Player;
+    if(m_Player != NULL)
+    {
+        if(m_Player->getMap()) m_Player->getMap()->removeActorFromMap(m_Player);
+        delete m_Player;
+    }
     m_Player = NULL;
 
     // clear message log
-    for(int i = 0; i < int(m_MessageLog.size()); i++) delete m_MessageLog[i];
     m_MessageLog.clear();
 
+    // drop any level still being generated
+    cancelPregeneration();
+
     // clear map data
     if(!m_Levels.empty())
     {
@@ -254,16 +321,20 @@ void Engine::clearGame()
 
 }
 
-void Engine::newGame()
+void Engine::newGame(uint64_t nseed)
 {
     m_Console->print("Starting new game...");
 
     // clear game data
     clearGame();
 
-    // init seed
-    m_Seed = time(NULL);
-    srand(m_Seed);
+    // init seed, 0 picks one from the clock
+    m_Seed = nseed ? nseed : uint64_t(time(NULL));
+    m_Random = getRandomStream(RNG_GAME);
+
+    std::stringstream sss;
+    sss << "Seed: " << m_Seed;
+    m_Console->print(sss.str());
 
     // init player
     vector2i playerpos(0,0);
@@ -276,18 +347,21 @@ void Engine::newGame()
     m_CurrentLevel = 0;
 
     // init maps
-    Map *newmap = new Map();
-    newmap->resize(100,100);
-    //generateLevel(newmap);
+    generateLevels(0, NEWGAME_LEVELS);
+    Map *newmap = m_Levels[m_CurrentLevel];
 
     // test level stuff
     //newmap->fill(2);
     //newmap->setTileAt(5,5,1);
-    //addItemToMap(newmap, newItem(0), 2, 2);
-    //addItemToMap(newmap, newItem(1), 4, 4);
-    //addActorToMap(newmap, newActor(0), 0, 3);
-    generateLevel(newmap);
-    m_Levels.push_back(newmap);
+    //newItem(0, newmap, 2, 2);
+    //newItem(1, newmap, 4, 4);
+    //newActor(0, newmap, 0, 3);
+
+    // put player in the current level's occupancy grid
+    newmap->placeActor(m_Player);
+
+    // start on the level after the ones built up front
+    pregenerateLevel(NEWGAME_LEVELS);
 
     // init camera
     m_Camera.setDimensions(40,20);
@@ -295,6 +369,8 @@ void Engine::newGame()
     m_Camera.setWorldPosition(0,0);
     m_Camera.setCenter(playerpos);
 
+    updatePlayerFOV();
+
     addMessage(&m_MessageLog, "Welcome!");
     addMessage(&m_MessageLog, "this is a test", COLOR(COLOR_RED, COLOR_BLACK, false));
     addMessage(&m_MessageLog, "and another..", COLOR(COLOR_BLUE, COLOR_BLACK, true));
@@ -305,14 +381,8 @@ void Engine::newGame()
 
 void Engine::setMainLoopEnvironment()
 {
-    // disable key echoing
-    noecho();
-
     // remove cursor
-    curs_set(0);
-
-    // disable screen scrolling
-    scrollok(stdscr, false);
+    m_Display->showCursor(false);
 }
 
 void Engine::mainLoop()
@@ -330,9 +400,8 @@ void Engine::mainLoop()
 
     while(!quit)
     {
-        // clear screen
-        clear();
-        attrset(A_NORMAL);
+        // start a new frame
+        m_Renderer.clear();
 
         // update
         vector2i playerpos = m_Player->getPosition();
@@ -341,15 +410,20 @@ void Engine::mainLoop()
         // draw
         drawCamera(&m_Camera);
         // draw message log
-        printMessages(&m_MessageLog, &messagelogrect);
+        printMessages(&m_MessageLog, &m_Renderer, &messagelogrect);
         // draw ui
         drawUI(40, 0 );
 
         // debug
-        mvprintw(0,0, "key:%d", ch);
+        std::stringstream kss;
+        kss << "key:" << ch;
+        m_Renderer.print(0, 0, kss.str());
+
+        // only send what changed since the last frame
+        m_Renderer.present();
 
         // get input
-        ch = getch();
+        ch = m_Display->getKey();
 
         // handle input
         if(ch == 27) quit = true;
@@ -359,6 +433,9 @@ void Engine::mainLoop()
 
             // set the curses environment back
             setMainLoopEnvironment();
+
+            // console commands may have changed the map or debug flags
+            updatePlayerFOV();
         }
         else if(ch == 49)
         {
@@ -425,6 +502,9 @@ void Engine::doTurn()
     // update player
     m_Player->update();
 
+    // recalculate what the player can see
+    updatePlayerFOV();
+
 }
 
 void Engine::drawCamera(Camera *tcamera)
@@ -444,9 +524,6 @@ void Engine::drawCamera(Camera *tcamera)
     // get player position
     vector2i playerpos = m_Player->getPosition();
 
-    // get player line of sight radius
-    int pradius = m_Player->getLOSRadius();
-
     // get tile count
     int tilecount = int(m_Tiles.size());
 
@@ -455,27 +532,10 @@ void Engine::drawCamera(Camera *tcamera)
     {
         for(int n = cpos.x; n < cpos.x + cwidth; n++)
         {
-            // position out of bounds?  ignore
-            if( n < 0 || n >= mapdims.x || i < 0 || i >= mapdims.y) continue;
-
-            // position within player's line of sight radius?
-            if(!m_DebugFlags[DBG_LIGHT])
-            {
-                if(n < playerpos.x - pradius || n > playerpos.x + pradius ||
-                   i < playerpos.y - pradius || i > playerpos.y + pradius) continue;
-
-                if( getDistance(n, i, playerpos.x, playerpos.y) > pradius ) continue;
-            }
-
-
-            // is within player line of sight?
-            if(!m_DebugFlags[DBG_LOS])
-                if(!inLOS(playerpos.x, playerpos.y, n, i)) continue;
-
+            if(!isCellDrawn(tmap, n, i)) continue;
 
             // get ascii
-            int tileindex = tmap->getMapTileIndexAt(vector2i(n,i));
-            if(tileindex == 0) continue;
+            int tileindex = tmap->getTileIndexUnchecked(n, i);
             //chtype ttile = m_Tiles[tileindex].m_Icon;
 
             vector2i drawpos = tcamera->PositionToScreen( vector2i(n,i));
@@ -483,167 +543,101 @@ void Engine::drawCamera(Camera *tcamera)
             // draw
             //mvaddch(drawpos.y, drawpos.x, ttile);
             if(tileindex < tilecount && tileindex >= 0)
-                m_Tiles[tileindex].m_Glyph.draw(drawpos.x, drawpos.y);
-
-            //draw items
-            std::vector<Item*> ilist = tmap->getItemsAt(n, i);
-            for(int k = 0; k < int(ilist.size()); k++)
-            {
-                glyph tglyph = ilist[k]->getGlyph();
-                tglyph.draw(drawpos.x, drawpos.y);
-            }
-
-            // draw actors
-            Actor *tactor = tmap->getActorAt(n, i);
-            if(tactor != NULL)
-            {
-                glyph tg = tactor->getGlyph();
-                tg.draw(drawpos.x, drawpos.y);
-            }
+                m_Tiles[tileindex].m_Glyph.draw(&m_Renderer, drawpos.x, drawpos.y);
         }
     }
 
+    // items and actors are drawn from the map's dense entity arrays,
+    // the objects themselves are not touched
+    // draw items, only the top item in the cell is visible
+    const EntityStore<Item> &istore = tmap->getItemStore();
+    const std::vector<Item*> &items = istore.getObjects();
+    const vector2i *ipos = istore.getPositions();
+    const chtype *irender = istore.getRender();
 
-    // draw player
-    if(tcamera->PositionInView(playerpos))
+    for(int i = 0; i < istore.size(); i++)
     {
-        vector2i playerposscr = tcamera->PositionToScreen(playerpos);
-        m_Player->getGlyph().draw(playerposscr.x, playerposscr.y);
-    }
-
-
-}
-
-void Engine::drawUI(int x, int y)
-{
-    std::stringstream uss;
-
-    mvprintw(y+1, x+2, m_Player->getName().c_str());
-
-    uss << "moves:" << m_PlayerMoveCount;
-    mvprintw(y+3, x+2, uss.str().c_str());
-}
-
-bool Engine::inLOS(int x1, int y1, int x2, int y2)
-{
-    Map *tmap = m_Levels[m_CurrentLevel];
-    vector2i mapdims = tmap->getDimensions();
+        if(!tcamera->PositionInView(ipos[i]) || !isCellDrawn(tmap, ipos[i].x, ipos[i].y)) continue;
+        if(tmap->getFirstItemAt(ipos[i].x, ipos[i].y) != items[i]) continue;
 
-    static const float roundoff = 0.8;
-
-    // if any of these coordinates are outside of current map, invalid
-    if(x1 < 0 || y1 < 0 || x2 < 0 || y2 < 0 ||
-       x1 >= mapdims.x || y1 >= mapdims.y || x2 >= mapdims.x || y2 >= mapdims.y) return false;
-
-    // get slope components
-    int rise = y2 - y1;
-    int run = x2 - x1;
+        vector2i drawpos = tcamera->PositionToScreen(ipos[i]);
+        m_Renderer.put(drawpos.x, drawpos.y, irender[i]);
+    }
 
-    // if point 1 and point 2 are the same
-    if(rise == 0 && run == 0) return true;
+    // draw actors
+    const EntityStore<Actor> &astore = tmap->getActorStore();
+    const vector2i *apos = astore.getPositions();
+    const chtype *arender = astore.getRender();
 
-    // make sure point 1 is to the left
-    // and swap coordinates if necessary
-    if(x1 > x2)
+    for(int i = 0; i < astore.size(); i++)
     {
-        int tx = x2;
-        x2 = x1;
-        x1 = tx;
+        if(!tcamera->PositionInView(apos[i]) || !isCellDrawn(tmap, apos[i].x, apos[i].y)) continue;
 
-        int ty = y2;
-        y2 = y1;
-        y1 = ty;
+        vector2i drawpos = tcamera->PositionToScreen(apos[i]);
+        m_Renderer.put(drawpos.x, drawpos.y, arender[i]);
     }
 
-    // horizontal
-    if(rise == 0)
-    {
-        for(int i = x1; i <= x2; i++)
-        {
-            // ignore origin and destination
-            if(i == x2 || i == x1) continue;
 
-            // los is blocked
-            //if( !m_Tiles[tmap->getMapTileIndexAt(i, y1)].m_Glyph.m_PassesLight) return false;
-            if( !lightPassesThroughAt(i, y1)) return false;
-        }
-    }
-    else if(run == 0)
+    // draw player
+    if(tcamera->PositionInView(playerpos))
     {
-        int ylo = 0;
-        int yhi = 0;
-
-        // find lowest/highest y coordinate
-        if(y1 < y2) {ylo = y1; yhi = y2;}
-        else {ylo = y2; yhi = y1;}
-
-        for(int i = ylo; i <= yhi; i++)
-        {
-            // ignore origin and destination
-            if(i == y2 || i == y1) continue;
-
-            // los is blocked
-            //if( !m_Tiles[tmap->getMapTileIndexAt(x1, i)].m_Glyph.m_PassesLight) return false;
-            if( !lightPassesThroughAt(x1, i) ) return false;
-        }
+        vector2i playerposscr = tcamera->PositionToScreen(playerpos);
+        m_Player->getGlyph().draw(&m_Renderer, playerposscr.x, playerposscr.y);
     }
-    // not ortho
-    else
-    {
-        // y = mx +b
-        // b = y - mx
-        float m = float(rise)/float(run);
-        float b = float(y1) - m*float(x1);
 
-        // y sweep
-        for(int i = x1; i <= x2; i++)
-        {
-            if(i == x1 || i == x2) continue;
 
-            float ty = m*float(i) + b;
-            double num;
-            float fract = modf(ty, &num);
+}
 
-            if(fract >= roundoff) ty = round(ty);
+// cell is on the map, lit and in the player's line of sight
+bool Engine::isCellDrawn(const Map *tmap, int x, int y) const
+{
+    // position out of bounds?  ignore
+    if(!tmap->isInBounds(x, y)) return false;
 
-            // los is blocked
-            //int tileindex = tmap->getMapTileIndexAt(i, int(ty));
-            //if( !m_Tiles[tileindex].m_Glyph.m_PassesLight) return false;
-            if( !lightPassesThroughAt(i, int(ty)) ) return false;;
-        }
+    // position within player's line of sight radius?
+    if(!m_DebugFlags[DBG_LIGHT])
+    {
+        vector2i playerpos = m_Player->getPosition();
+        int pradius = m_Player->getLOSRadius();
 
-        //x sweep
+        if(x < playerpos.x - pradius || x > playerpos.x + pradius ||
+           y < playerpos.y - pradius || y > playerpos.y + pradius) return false;
 
-        // y = mx +b
-        // x = (y-b)/m
-        int ylo = 0;
-        int yhi = 0;
+        if( getDistance(x, y, playerpos.x, playerpos.y) > pradius ) return false;
+    }
 
-        if(y1 < y2) {ylo = y1; yhi = y2;}
-        else {ylo = y2; yhi = y1;}
+    // is within player line of sight?
+    if(!m_DebugFlags[DBG_LOS])
+        if(!m_PlayerFOV.isVisible(x, y)) return false;
 
-        for(int i = ylo; i <= yhi; i++)
-        {
-            if(i == y1 || i == y2) continue;
+    // no tile, nothing is drawn
+    return tmap->getTileIndexUnchecked(x, y) != 0;
+}
 
-            float tx = ( float(i)-b) / m;
-            double num;
-            float fract = modf(tx, &num);
+void Engine::drawUI(int x, int y)
+{
+    std::stringstream uss;
 
-            if(fract >= roundoff) tx = round(tx);
+    m_Renderer.print(x+2, y+1, m_Player->getName());
 
-            // los is blocked
-            //int tileindex = tmap->getMapTileIndexAt( int(tx), i );
-            //if( !m_Tiles[tileindex].m_Glyph.m_PassesLight) return false;
-            if( !lightPassesThroughAt( int(tx), i)) return false;
-        }
+    uss << "moves:" << m_PlayerMoveCount;
+    m_Renderer.print(x+2, y+3, uss.str());
+}
 
+void Engine::updatePlayerFOV()
+{
+    if(m_Player == NULL || m_Levels.empty()) return;
+
+    // with lighting disabled, everything in the camera is in range
+    int radius = m_Player->getLOSRadius();
+    if(m_DebugFlags[DBG_LIGHT])
+    {
+        radius = std::max( int(m_Camera.getWidth()), int(m_Camera.getHeight()) )/2 + 1;
     }
 
-    return true;
+    m_PlayerFOV.compute(m_Levels[m_CurrentLevel], m_Player->getPosition(), radius);
 }
 
-
 bool Engine::walkActor(Actor *tactor, int dir, bool noclip)
 {
     if(tactor == NULL) return false;
@@ -701,12 +695,8 @@ bool Engine::walkActor(Actor *tactor, int dir, bool noclip)
         // tile is unwalkable
         if(!isWalkableAt(npos.x, npos.y))
         {
-            // get items at blocked position
-            std::vector<Item*> titems = m_Levels[m_CurrentLevel]->getItemsAt( npos.x, npos.y);
-
             // if an actor is there (mob or player)
             Actor *bactor = tmap->getActorAt(npos.x, npos.y);
-            if(!bactor && m_Player->getPosition().x == npos.x && m_Player->getPosition().y == npos.y) bactor = m_Player;
 
             // if found actor is not current target actor, actor collision (attack)
             if(bactor != tactor && bactor != NULL)
@@ -719,15 +709,15 @@ bool Engine::walkActor(Actor *tactor, int dir, bool noclip)
             // check if colliding with a closed door
             else
             {
-                // check each item in list at position
-                for(int i = 0; i < int(titems.size()); i++)
+                // check each item at blocked position
+                for(Item *titem = tmap->getFirstItemAt(npos.x, npos.y); titem != NULL; titem = titem->getNextItemInCell())
                 {
                     // if door is found in list
-                    if( titems[i]->getDoor())
+                    if( titem->getDoor())
                     {
 
                         // attempt to open door
-                        if(titems[i]->openDoor())
+                        if(titem->openDoor())
                         {
                             // if successful, do turn
                             doTurn();
@@ -748,29 +738,31 @@ bool Engine::walkActor(Actor *tactor, int dir, bool noclip)
     // if actor is player, find and print any items at their feet
     if(tactor == m_Player)
     {
-        std::vector<Item*> titems = m_Levels[m_CurrentLevel]->getItemsAt( m_Player->getPosition().x, m_Player->getPosition().y);
+        Item *titem = tmap->getFirstItemAt( npos.x, npos.y);
 
-        if(!titems.empty())
+        if(titem != NULL)
         {
 
-            std::stringstream ifind;
-            ifind << "You see ";
+            std::string ifind("You see ");
 
-            for(int n = 0; n < int(titems.size()); n++)
+            for(; titem != NULL; titem = titem->getNextItemInCell())
             {
                 // if item has article add a space after
-                if(titems[n]->getArticle() != "")
-                    ifind << titems[n]->getArticle() << " ";
+                if(!titem->getArticleSymbol().empty())
+                {
+                    ifind += titem->getArticle();
+                    ifind += ' ';
+                }
 
                 // add item name
-                ifind << titems[n]->getName();
+                ifind += titem->getName();
 
                 // determine separator
-                if(n == int(titems.size())-1) ifind << ".";
-                else ifind << ",";
+                if(titem->getNextItemInCell() == NULL) ifind += '.';
+                else ifind += ',';
             }
 
-            addMessage(&m_MessageLog, ifind.str());
+            addMessage(&m_MessageLog, ifind);
 
         }
 
@@ -782,87 +774,129 @@ bool Engine::walkActor(Actor *tactor, int dir, bool noclip)
     return true;
 }
 
-bool Engine::generateLevel(Map *tmap)
+Random Engine::getRandomStream(E_RNGSTREAM stype, unsigned int index) const
 {
-    if(tmap == NULL) return false;
+    return Random(m_Seed, getRandomStreamID(stype, index));
+}
 
-    // get map dimensions
-    vector2i mapdims = tmap->getDimensions();
-    long int maparea = mapdims.x * mapdims.y;
+bool Engine::generateLevel(Map *tmap, Random *trng)
+{
+    return m_LevelGen.generate(tmap, trng);
+}
 
-    // clear map data
-    tmap->clear();
+void Engine::generateLevels(int first, int count)
+{
+    std::vector<LevelJob*> jobs;
 
+    if(int(m_Levels.size()) < first + count) m_Levels.resize(first + count, NULL);
 
-    // generation parameters
-    bool allowoverlap = true; // allow tiles to be placed over tiles
-    bool addwallborder = true;
-    int riterations = 0.02 * maparea; // how my times to run through algorithm
-    // room sizes
-    int rwidth_min = 3;
-    int rwidth_max = 6;
-    int rheight_min = 3;
-    int rheight_max = 6;
+    // each level has its own rng stream, so the result does not depend on
+    // which worker builds it or in what order
+    for(int i = first; i < first + count; i++)
+    {
+        if(m_Levels[i] == NULL)
+        {
+            m_Levels[i] = new Map();
+            m_Levels[i]->setTileSet(&m_Tiles);
+            m_Levels[i]->resize(100,100);
+        }
 
+        jobs.push_back( new LevelJob(&m_LevelGen, m_Levels[i], getRandomStream(RNG_LEVEL, i)) );
+        m_Workers.submit(jobs.back());
+    }
 
+    for(int i = 0; i < int(jobs.size()); i++)
+    {
+        m_Workers.wait(jobs[i]);
+        delete jobs[i];
+    }
+}
+void Engine::pregenerateLevel(int level)
+{
+    if(level < 0) return;
 
+    // already built or already on its way
+    if(level < int(m_Levels.size()) && m_Levels[level] != NULL) return;
+    if(m_NextLevelJob != NULL) return;
 
-    // generate random rooms
-    for(int k = 0; k < riterations; k++)
-    {
-        // get room dimensions
-        int rwidth = rand()%(rwidth_max-rwidth_min) + rwidth_min;
-        int rheight = rand()%(rheight_max-rheight_min) + rheight_min;
-
-        // get room position
-        vector2i rpos;
-        rpos.x = rand()%mapdims.x;
-        rpos.y = rand()%mapdims.y;
-
-        // check for room placement validity
-        bool validpos = true;
-        for(int i = rpos.y; i < rpos.y + rheight; i++)
-        {
-            for(int n = rpos.x; n < rpos.x + rwidth; n++)
-            {
-                if(n < 0 || n >= mapdims.x || i < 0 || i >= mapdims.y)
-                {
-                    validpos = false;
-                }
-                else
-                {
-                    if(!allowoverlap)
-                    {
-                        int tindex = tmap->getMapTileIndexAt( unsigned(n), unsigned(i));
-                        //Tile *ttile = &m_Tiles[tindex];
+    Map *newmap = new Map();
+    newmap->setTileSet(&m_Tiles);
+    newmap->resize(100,100);
 
-                        if(tindex != 0) validpos = false;
-                    }
-                }
+    m_NextLevel = level;
+    m_NextLevelJob = new LevelJob(&m_LevelGen, newmap, getRandomStream(RNG_LEVEL, level));
+    m_Workers.submit(m_NextLevelJob);
+}
 
-                if(!validpos) break;
-            }
+void Engine::cancelPregeneration()
+{
+    if(m_NextLevelJob == NULL) return;
 
-            if(!validpos) break;
-        }
+    // the worker may be writing to the map, let it finish first
+    m_Workers.wait(m_NextLevelJob);
 
-        if(!validpos) continue;
+    delete m_NextLevelJob->getMap();
+    delete m_NextLevelJob;
 
-        // position is valid, populate room
-        for(int i = rpos.y; i < rpos.y + rheight; i++)
-        {
-            for(int n = rpos.x; n < rpos.x + rwidth; n++)
-            {
-                tmap->setTileAt(n, i, 2);
-            }
-        }
+    m_NextLevelJob = NULL;
+    m_NextLevel = -1;
+}
 
+Map *Engine::getLevel(int level)
+{
+    if(level < 0) return NULL;
+
+    if(level < int(m_Levels.size()) && m_Levels[level] != NULL) return m_Levels[level];
+
+    if(int(m_Levels.size()) <= level) m_Levels.resize(level + 1, NULL);
+
+    // hand over the background level, blocks if it is not done yet
+    if(m_NextLevelJob != NULL && m_NextLevel == level)
+    {
+        if(!m_Workers.isDone(m_NextLevelJob)) m_Console->print("Waiting for level generation...");
+
+        m_Workers.wait(m_NextLevelJob);
+        m_Levels[level] = m_NextLevelJob->getMap();
+
+        delete m_NextLevelJob;
+        m_NextLevelJob = NULL;
+        m_NextLevel = -1;
     }
+    // nothing queued for it, build it now
+    else generateLevels(level, 1);
+
+    return m_Levels[level];
+}
+
+bool Engine::changeLevel(int level)
+{
+    if(level < 0 || level == m_CurrentLevel) return false;
+
+    Map *newmap = getLevel(level);
+    if(newmap == NULL) return false;
+
+    // levels don't line up, put the player on the open cell closest to where they were
+    vector2i ppos;
+    if(!newmap->findOpenCell(m_Player->getPosition(), &ppos)) return false;
+
+    // move the player over
+    if(m_Player->getMap()) m_Player->getMap()->removeActorFromMap(m_Player);
+    m_CurrentLevel = level;
+    m_Player->setPosition(ppos);
+    newmap->placeActor(m_Player);
 
-    // if adding wall borders
+    std::stringstream lss;
+    lss << "You are now on level " << m_CurrentLevel + 1 << ".";
+    addMessage(&m_MessageLog, lss.str());
+
+    // get the next one started while the player is here
+    pregenerateLevel(m_CurrentLevel + 1);
+
+    updatePlayerFOV();
 
     return true;
 }
+
 void Engine::exportMapToASCIIFile(const Map *tmap, std::string fname)
 {
     if(!tmap) return;
@@ -876,7 +910,7 @@ void Engine::exportMapToASCIIFile(const Map *tmap, std::string fname)
     {
         for(int n = 0; n < mapd.x; n++)
         {
-            int ttilenum = tmap->getMapTileIndexAt(n, i);
+            int ttilenum = tmap->getTileIndexUnchecked(n, i);
 
             if(ttilenum == 0) ofile << " ";
             else ofile << char(m_Tiles[ttilenum].m_Glyph.m_Character);
@@ -891,61 +925,16 @@ bool Engine::lightPassesThroughAt(int x, int y, Map *tmap)
 {
     if(tmap == NULL) tmap = m_Levels[m_CurrentLevel];
 
-    vector2i dims = tmap->getDimensions();
-    Tile *ttile = NULL;
-    std::vector<Item*> titems;
-
-    // check x,y validity
-    if(int(x) >= dims.x || int(y) >= dims.y) return false;
-
-    // get tile at x,y and check if passes light
-    int ti = tmap->getMapTileIndexAt(x,y);
-    if(ti >= int(m_Tiles.size()) ) return false;
-    ttile = &m_Tiles[ti];
-    if(!ttile) return false;
-    if( !ttile->m_Glyph.m_PassesLight ) return false;
-
-    // get items at x,y and check if passes light
-    titems = tmap->getItemsAt(x, y);
-    for(int i = 0; i < int(titems.size()); i++)
-    {
-        if( !titems[i]->getGlyph().m_PassesLight) return false;
-    }
-
-
-
-    return true;
+    // tile, items and actors are combined in the map's cached cell flags
+    return !tmap->blocksLightAt(x, y);
 }
 
 bool Engine::isWalkableAt(int x, int y, Map *tmap)
 {
     if(tmap == NULL) tmap = m_Levels[m_CurrentLevel];
 
-    vector2i dims = tmap->getDimensions();
-    Tile *ttile = NULL;
-    std::vector<Item*> titems;
-
-    // check x,y validity
-    if(int(x) >= dims.x || int(y) >= dims.y) return false;
-
-    // get tile at x,y and check if passes light
-    ttile = &m_Tiles[tmap->getMapTileIndexAt(x,y)];
-    if(!ttile) return false;
-    if( !ttile->m_Glyph.m_Walkable ) return false;
-
-    // get items at x,y and check if passes light
-    titems = tmap->getItemsAt(x, y);
-    for(int i = 0; i < int(titems.size()); i++)
-    {
-        if( !titems[i]->getGlyph().m_Walkable) return false;
-    }
-
-    // check if an actor occupies that space
-    if(tmap->getActorAt(x, y)) return false;
-    vector2i ppos = m_Player->getPosition();
-    if(ppos.x == x && ppos.y == y) return false;
-
-    return true;
+    // tile, items and actors (mob or player) are combined in the map's cached cell flags
+    return !tmap->blocksMoveAt(x, y);
 }
 
 bool Engine::openDoorAt(int x, int y, Map *tmap)
@@ -970,6 +959,14 @@ Item *Engine::newItem(int itmindex)
     return newitem;
 }
 
+Item *Engine::newItem(int itmindex, Map *tlevel, int x, int y)
+{
+    if(tlevel == NULL) return NULL;
+    if(itmindex < 0 || itmindex >= int(m_Items.size()) ) return NULL;
+
+    return tlevel->createItem(*m_Items[itmindex], x, y);
+}
+
 bool Engine::addItemToMap(Map *tlevel, Item *titem, int x, int y)
 {
     // level and item valid?
@@ -995,15 +992,12 @@ Item *Engine::pickupItemFromMapAt(Actor *tactor, Map *tlevel, vector2i tpos)
 {
     if(tactor == NULL || tlevel == NULL) return NULL;
 
-    // get list of items at target position
-    std::vector<Item*> ilist = tlevel->getItemsAt(tpos.x, tpos.y);
-
-    // get first item in the list?
-    for(int i = 0; i < int(ilist.size()); i++)
+    // get the top most item at target position that can be picked up
+    for(Item *ditem = tlevel->getFirstItemAt(tpos.x, tpos.y); ditem != NULL; ditem = ditem->getNextItemInCell())
     {
-        if(ilist[i]->canPickup())
+        if(ditem->canPickup())
         {
-            Item *titem = tlevel->removeItemFromMap(ilist[i]);
+            Item *titem = tlevel->removeItemFromMap(ditem);
             tactor->addItemToInventory(titem);
 
             return titem;
@@ -1020,16 +1014,19 @@ void Engine::printInventory(std::vector<Item*> *ilist)
 
     if(ilist->empty())
     {
-        printw("You are not carring anything!\n");
+        m_Renderer.print(0, 0, "You are not carring anything!");
     }
     else
     {
-        printw("Inventory\n");
-        printw("---------\n");
+        m_Renderer.print(0, 0, "Inventory");
+        m_Renderer.print(0, 1, "---------");
 
         for(int i = 0; i < int(ilist->size()); i++)
         {
-            printw("%c - %s", getIndexChar(i), (*ilist)[i]->getName().c_str());
+            std::string iline(1, getIndexChar(i));
+            iline += " - ";
+            iline += (*ilist)[i]->getName();
+            m_Renderer.print(0, i+2, iline);
         }
     }
 }
@@ -1043,11 +1040,13 @@ void Engine::openInventory()
 
     while(!doquit)
     {
-        clear();
+        m_Renderer.clear();
 
         printInventory(inventory);
 
-        ch = getch();
+        m_Renderer.present();
+
+        ch = m_Display->getKey();
 
         if(ch == 27) doquit = true; // escape
         else if(ch == 10) doquit = true; // enter
@@ -1064,19 +1063,21 @@ Item *Engine::dropItem()
 
     while(!doquit)
     {
-        clear();
+        m_Renderer.clear();
 
         printInventory(inventory);
 
         if(inventory->empty())
         {
-            getch();
+            m_Renderer.present();
+            m_Display->getKey();
             return NULL;
         }
 
-        mvprintw(24, 0, "Drop what?");
+        m_Renderer.print(0, 24, "Drop what?");
+        m_Renderer.present();
 
-        ch = getch();
+        ch = m_Display->getKey();
 
         if(ch == 27) doquit = true; // escape
         else if(ch == 10) doquit = true; // enter
@@ -1089,17 +1090,19 @@ Item *Engine::dropItem()
                 // player position
                 vector2i ppos = m_Player->getPosition();
 
-                // get and remove item from inventory
+                // the level keeps its own pooled copy of the item
                 Item *titem = (*inventory)[iindex];
-                inventory->erase(inventory->begin() + iindex);
+                Item *mitem = m_Levels[m_CurrentLevel]->createItem(*titem, ppos.x, ppos.y);
+                if(mitem == NULL) return NULL;
 
-                // add item to map
-                addItemToMap(m_Levels[m_CurrentLevel], titem, ppos.x, ppos.y);
+                // remove item from inventory
+                inventory->erase(inventory->begin() + iindex);
+                delete titem;
 
                 // update
                 doTurn();
 
-                return titem;
+                return mitem;
             }
         }
     }
@@ -1122,6 +1125,14 @@ Actor *Engine::newActor(int aindex)
     return newactor;
 }
 
+Actor *Engine::newActor(int aindex, Map *tlevel, int x, int y)
+{
+    if(tlevel == NULL) return NULL;
+    if(aindex < 0 || aindex >= int(m_Actors.size()) ) return NULL;
+
+    return tlevel->createActor(*m_Actors[aindex], x, y);
+}
+
 bool Engine::addActorToMap(Map *tlevel, Actor *tactor, int x, int y)
 {
     // level and item valid?
@@ -1142,15 +1153,14 @@ bool Engine::addActorToMap(Map *tlevel, Actor *tactor, int x, int y)
 
     return true;
 }
+
+
 /////////////////////////////////////////////////////////////////
 //
 
 int Engine::getColorPair(COLOR tcolor)
 {
-    if(tcolor.m_Foreground < 0 || tcolor.m_Background < 0 ||
-       tcolor.m_Foreground >= MAX_COLORS || tcolor.m_Background >= MAX_COLORS)
-        return 0;
-    else return m_ColorTable[tcolor.m_Background][tcolor.m_Foreground];
+    return ::getColorPair(tcolor);
 }
 
 /////////////////////////////////////////////////////////////////
@@ -0,0 +1,127 @@
+#include "fov.hpp"
+#include "map.hpp"
+
+FieldOfView::FieldOfView()
+{
+    m_Radius = -1;
+    m_Size = 0;
+
+    m_Map = NULL;
+}
+
+FieldOfView::~FieldOfView()
+{
+
+}
+
+void FieldOfView::clear()
+{
+    std::fill(m_Bits.begin(), m_Bits.end(), 0u);
+}
+
+void FieldOfView::setVisible(int x, int y)
+{
+    if(!m_Map->isInBounds(x, y)) return;
+
+    int bit = (y - m_Origin.y + m_Radius)*m_Size + (x - m_Origin.x + m_Radius);
+
+    m_Bits[bit >> 5] |= 1u << (bit & 31);
+}
+
+bool FieldOfView::isVisible(int x, int y) const
+{
+    int lx = x - m_Origin.x + m_Radius;
+    int ly = y - m_Origin.y + m_Radius;
+
+    if(m_Radius < 0 || lx < 0 || ly < 0 || lx >= m_Size || ly >= m_Size) return false;
+
+    int bit = ly*m_Size + lx;
+
+    return (m_Bits[bit >> 5] >> (bit & 31)) & 1u;
+}
+
+void FieldOfView::compute(const Map *tmap, vector2i origin, int radius)
+{
+    // octant transforms, maps (dx,dy) of the scan into map space
+    static const int mult[4][8] = {
+        {1,  0,  0, -1, -1,  0,  0,  1},
+        {0,  1, -1,  0,  0, -1,  1,  0},
+        {0,  1,  1,  0,  0, -1, -1,  0},
+        {1,  0,  0,  1, -1,  0,  0, -1}};
+
+    if(radius < 0) radius = 0;
+
+    m_Origin = origin;
+    m_Radius = radius;
+    m_Size = radius*2 + 1;
+    m_Bits.assign( (m_Size*m_Size + 31) / 32, 0u);
+
+    if(tmap == NULL) return;
+
+    m_Map = tmap;
+
+    // origin can always see itself
+    setVisible(origin.x, origin.y);
+
+    for(int i = 0; i < 8; i++)
+    {
+        castLight(1, 1.0, 0.0, mult[0][i], mult[1][i], mult[2][i], mult[3][i]);
+    }
+
+    m_Map = NULL;
+}
+
+// scan one octant row by row, start and end are the slopes of the
+// visible wedge, a blocking cell splits the wedge and the part in front
+// of it is scanned recursively
+void FieldOfView::castLight(int row, float start, float end, int xx, int xy, int yx, int yy)
+{
+    if(start < end) return;
+
+    float newstart = 0.0;
+
+    for(int j = row; j <= m_Radius; j++)
+    {
+        bool blocked = false;
+        int dy = -j;
+
+        for(int dx = -j; dx <= 0; dx++)
+        {
+            int mx = m_Origin.x + dx*xx + dy*xy;
+            int my = m_Origin.y + dx*yx + dy*yy;
+
+            // slopes of the cell's left and right edges
+            float lslope = (float(dx) - 0.5) / (float(dy) + 0.5);
+            float rslope = (float(dx) + 0.5) / (float(dy) - 0.5);
+
+            if(start < rslope) continue;
+            else if(end > lslope) break;
+
+            setVisible(mx, my);
+
+            if(blocked)
+            {
+                // still scanning blocking cells
+                if(m_Map->blocksLightAt(mx, my))
+                {
+                    newstart = rslope;
+                    continue;
+                }
+                else
+                {
+                    blocked = false;
+                    start = newstart;
+                }
+            }
+            else if(m_Map->blocksLightAt(mx, my) && j < m_Radius)
+            {
+                // hit a wall, scan the part of the wedge before it
+                blocked = true;
+                castLight(j+1, start, lslope, xx, xy, yx, yy);
+                newstart = rslope;
+            }
+        }
+
+        if(blocked) break;
+    }
+}
@@ -1,6 +1,5 @@
 #include "glyph.hpp"
-#include "console.hpp" // for debug printinfo
-#include "engine.hpp"  // for debug printinfo
+#include "tools.hpp"
 #include <sstream> // for debug printinfo
 
 using namespace tinyxml2;
@@ -12,6 +11,9 @@ glyph::glyph()
     m_Walkable = true;
     m_PassesLight = true;
     m_CanPickup = false;
+
+    // not resolved yet, draws without color
+    m_Render = m_Character;
 }
 
 glyph::~glyph()
@@ -58,43 +60,32 @@ bool glyph::loadFromXMLNode(XMLNode *tnode)
         anode = anode->NextSibling();
     }
 
+    resolve();
+
     return true;
 }
-void glyph::draw(int x, int y)
-{
-    Engine *eptr = Engine::getInstance();
-    int cpair = eptr->getColorPair( m_Color);
-
 
-    //reset colors
-    attrset( COLOR_PAIR(eptr->getColorPair(COLOR(COLOR_WHITE, COLOR_BLACK, false))) | A_NORMAL);
+void glyph::resolve()
+{
+    m_Render = m_Character | COLOR_PAIR(getColorPair(m_Color));
 
     // if glyph is bold
-    if(m_Color.m_Bold) attrset( A_BOLD);
-
-    // set color
-    attron( COLOR_PAIR(eptr->getColorPair(m_Color)) );
-
-    // draw glyph
-    mvaddch(y, x, m_Character);
+    if(m_Color.m_Bold) m_Render |= A_BOLD;
 }
 
 void glyph::printInfo() const
 {
-    Console *console = Console::getInstance();
-    Engine *eptr = Engine::getInstance();
-
     std::stringstream ss;
     ss << "Glyph Char:" << char(m_Character);
-    console->print(ss.str());
+    printInfoLine(ss.str());
     ss.str(std::string());
     ss << "Walkable:" << m_Walkable;
-    console->print(ss.str());
+    printInfoLine(ss.str());
     ss.str(std::string());
     ss << "Passes Light:" << m_PassesLight;
-    console->print(ss.str());
+    printInfoLine(ss.str());
     ss.str(std::string());
     ss << "Can Pickup:" << m_CanPickup;
-    console->print(ss.str());
+    printInfoLine(ss.str());
 
 }
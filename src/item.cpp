@@ -1,5 +1,4 @@
 #include "item.hpp"
-#include "console.hpp"
 #include <sstream>
 
 using namespace tinyxml2;
@@ -11,27 +10,86 @@ Item::Item()
 
     // null pointers
     m_Door = NULL;
+    m_DoorPool = NULL;
+    m_DoorSlot = -1;
+    m_CellPrev = NULL;
+    m_CellNext = NULL;
 }
 
 Item::Item(const Item &titem) : WorldObject(titem)
 {
-    *this = titem;
+    // copies are not placed on any map
+    m_CellPrev = NULL;
+    m_CellNext = NULL;
+
+    m_Door = NULL;
+    m_DoorPool = NULL;
+    m_DoorSlot = -1;
+
+    copyFrom(titem);
+}
+
+Item::Item(const Item &titem, ObjectPool<Door> *doorpool) : WorldObject(titem)
+{
+    m_CellPrev = NULL;
+    m_CellNext = NULL;
+
+    m_Door = NULL;
+    m_DoorPool = doorpool;
+    m_DoorSlot = -1;
+
+    copyFrom(titem);
+}
+
+Item &Item::operator=(const Item &titem)
+{
+    if(this == &titem) return *this;
+
+    WorldObject::operator=(titem);
+    copyFrom(titem);
+
+    return *this;
+}
+
+// copy the item data, the door is duplicated rather than shared
+void Item::copyFrom(const Item &titem)
+{
+    m_Value = titem.m_Value;
+    m_Weight = titem.m_Weight;
+
+    // a new door comes from the same pool as the old one
+    ObjectPool<Door> *doorpool = m_DoorPool;
+    releaseDoor();
+    m_DoorPool = doorpool;
 
     if(titem.m_Door)
     {
-        m_Door = new Door(*titem.m_Door, this);
+        if(m_DoorPool) m_Door = m_DoorPool->create(*titem.m_Door, this, &m_DoorSlot);
+        else m_Door = new Door(*titem.m_Door, this);
     }
 }
 
 Item::~Item()
 {
-    if(m_Door) delete m_Door;
+    releaseDoor();
+}
+
+void Item::releaseDoor()
+{
+    if(m_Door == NULL) return;
+
+    if(m_DoorPool) m_DoorPool->destroy(m_Door, m_DoorSlot);
+    else delete m_Door;
+
+    m_Door = NULL;
+    m_DoorPool = NULL;
+    m_DoorSlot = -1;
 }
 
 // door
 void Item::setDoor(Door *tdoor)
 {
-    if(m_Door) delete m_Door;
+    releaseDoor();
 
     m_Door = tdoor;
     m_Door->setParent(this);
@@ -84,20 +142,18 @@ void Item::printInfo()
 	// print parent class
 	WorldObject::printInfo();
 
-    Console *console = Console::getInstance();
-
     std::stringstream ss;
     ss << "Value:" << getValue();
-    console->print(ss.str() );
+    printInfoLine(ss.str() );
     ss.str(std::string());
 
     ss << "Weight:" << getWeight();
-    console->print(ss.str());
+    printInfoLine(ss.str());
     ss.str(std::string());
 
     ss << "Components:";
     if(m_Door) ss << "Door,";
-    console->print(ss.str());
+    printInfoLine(ss.str());
     ss.str(std::string());
 }
 
@@ -195,11 +251,10 @@ bool Door::isHorizontal() const
 void Door::printInfo() const
 {
 
-    Console *console = Console::getInstance();
 
     std::stringstream ss;
     ss << "Door State:" << m_State;
-    console->print(ss.str() );
+    printInfoLine(ss.str() );
     ss.str(std::string());
 
 }
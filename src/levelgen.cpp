@@ -0,0 +1,354 @@
+#include "levelgen.hpp"
+#include "map.hpp"
+#include "random.hpp"
+#include "rectindex.hpp"
+#include "bitgrid.hpp"
+#include "unionfind.hpp"
+#include "prefab.hpp"
+
+#include <algorithm>
+
+LevelGenerator::LevelGenerator()
+{
+    m_AllowOverlap = true;
+    m_AddWallBorder = true;
+    m_ConnectRegions = true;
+    m_RoomDensity = 0.02;
+    m_Prefabs = NULL;
+    m_PrefabDensity = 0.0003;
+
+    setRoomSize(3, 6, 3, 6);
+
+    m_Type = LEVEL_ROOMS;
+
+    // walls with 4+ wall neighbors stay, floors with 5+ become walls
+    m_CaveFill = 0.45;
+    m_CaveIterations = 4;
+    m_CaveBirth = 0x1E0;
+    m_CaveSurvival = 0x1F0;
+}
+
+LevelGenerator::~LevelGenerator()
+{
+
+}
+
+void LevelGenerator::setRoomSize(int wmin, int wmax, int hmin, int hmax)
+{
+    m_RoomWidthMin = wmin;
+    m_RoomWidthMax = wmax;
+    m_RoomHeightMin = hmin;
+    m_RoomHeightMax = hmax;
+}
+
+bool LevelGenerator::generate(Map *tmap, Random *trng, LevelGenInfo *tinfo) const
+{
+    if(tmap == NULL || trng == NULL) return false;
+
+    bool generated = false;
+
+    if(m_Type == LEVEL_CAVES) generated = generateCaves(tmap, trng, tinfo);
+    else generated = generateRooms(tmap, trng, tinfo);
+
+    if(!generated) return false;
+
+    if(m_ConnectRegions) connectRegions(tmap, tinfo);
+    if(m_AddWallBorder) addWallBorders(tmap);
+
+    // tiles were written directly, rebuild the cell flags
+    tmap->refreshAllCells();
+
+    return true;
+}
+
+bool LevelGenerator::generateRooms(Map *tmap, Random *trng, LevelGenInfo *tinfo) const
+{
+    // get map dimensions
+    vector2i mapdims = tmap->getDimensions();
+    long int maparea = mapdims.x * mapdims.y;
+
+    // clear map data
+    tmap->clear();
+
+    int riterations = m_RoomDensity * maparea; // how my times to run through algorithm
+
+    // rooms placed so far, for overlap tests
+    RectIndex rooms;
+    if(!m_AllowOverlap) rooms.reset(mapdims.x, mapdims.y, std::max(m_RoomWidthMax, m_RoomHeightMax));
+
+    // generate random rooms
+    for(int k = 0; k < riterations; k++)
+    {
+        // get room dimensions
+        int rwidth = trng->getRange(m_RoomWidthMin, m_RoomWidthMax);
+        int rheight = trng->getRange(m_RoomHeightMin, m_RoomHeightMax);
+
+        // get room position
+        vector2i rpos;
+        rpos.x = trng->getInt(mapdims.x);
+        rpos.y = trng->getInt(mapdims.y);
+
+        // check for room placement validity
+        // room must fit entirely within the map
+        if(rpos.x + rwidth > mapdims.x || rpos.y + rheight > mapdims.y) continue;
+
+        recti troom(rpos.x, rpos.y, rwidth, rheight);
+        if(!m_AllowOverlap)
+        {
+            if(rooms.overlaps(troom)) continue;
+            rooms.add(troom);
+        }
+
+        // position is valid, populate room
+        tmap->fillRect(troom, TILE_FLOOR);
+
+        if(tinfo) tinfo->m_RoomCount++;
+
+    }
+
+    // stamp a few prefabs on top of the rooms
+    if(m_Prefabs == NULL || m_Prefabs->empty()) return true;
+
+    int piterations = m_PrefabDensity * maparea;
+
+    for(int k = 0; k < piterations; k++)
+    {
+        const Prefab *tprefab = &(*m_Prefabs)[ trng->getInt( int(m_Prefabs->size()) ) ];
+
+        vector2i ppos;
+        ppos.x = trng->getInt(mapdims.x);
+        ppos.y = trng->getInt(mapdims.y);
+
+        if(ppos.x + tprefab->m_Width > mapdims.x || ppos.y + tprefab->m_Height > mapdims.y) continue;
+
+        recti tarea(ppos.x, ppos.y, tprefab->m_Width, tprefab->m_Height);
+        if(!m_AllowOverlap)
+        {
+            if(rooms.overlaps(tarea)) continue;
+            rooms.add(tarea);
+        }
+
+        tmap->stampPrefab(tprefab, ppos.x, ppos.y);
+
+        if(tinfo) tinfo->m_PrefabCount++;
+    }
+
+    return true;
+}
+
+// caves have no rooms or prefabs to count, their regions are counted by connectRegions
+bool LevelGenerator::generateCaves(Map *tmap, Random *trng, LevelGenInfo */*tinfo*/) const
+{
+    vector2i mapdims = tmap->getDimensions();
+
+    tmap->clear();
+    if(mapdims.x <= 0 || mapdims.y <= 0) return true;
+
+    // set bits are walls, the map edge counts as wall
+    BitGrid cells;
+    cells.resize(mapdims.x, mapdims.y);
+    cells.fillRandom(trng, m_CaveFill);
+
+    for(int i = 0; i < m_CaveIterations; i++) cells.step(m_CaveBirth, m_CaveSurvival);
+
+    // expand the bits into tile rows
+    std::vector<int> row(mapdims.x);
+
+    for(int y = 0; y < mapdims.y; y++)
+    {
+        const uint64_t *bits = cells.getRow(y);
+
+        for(int x = 0; x < mapdims.x; x++)
+        {
+            row[x] = (bits[x >> 6] >> (x & 63)) & 1 ? TILE_WALL : TILE_FLOOR;
+        }
+
+        tmap->setTileRow(0, y, &row[0], mapdims.x);
+    }
+
+    return true;
+}
+
+// shortest rock path joining two regions, between cells m_A and m_B
+struct RegionLink
+{
+    int m_Length;
+    int m_A;
+    int m_B;
+
+    RegionLink() : m_Length(0), m_A(0), m_B(0) {};
+    RegionLink(int nlength, int na, int nb) : m_Length(nlength), m_A(na), m_B(nb) {};
+};
+
+void LevelGenerator::connectRegions(Map *tmap, LevelGenInfo *tinfo) const
+{
+    int width = tmap->getWidth();
+    int height = tmap->getHeight();
+    if(width <= 0 || height <= 0) return;
+
+    int cells = width*height;
+
+    std::vector<unsigned char> open(cells);
+    for(int y = 0; y < height; y++)
+    {
+        const int *row = tmap->getTileRow(y);
+        for(int x = 0; x < width; x++) open[y*width + x] = row[x] == TILE_FLOOR;
+    }
+
+    std::vector<int> labels;
+    int count = labelRegions(&open[0], width, height, &labels);
+
+    if(tinfo) tinfo->m_RegionCount = count;
+    if(count < 2) return;
+
+    // grow every region into the rock at once, breadth first, each cell
+    // keeps the region that reached it first, its distance and the cell
+    // it was reached from, -1 is unclaimed rock
+    std::vector<int> owner(labels);
+    std::vector<int> dist(cells, 0);
+    std::vector<int> from(cells, -1);
+    std::vector<int> queue;
+    queue.reserve(cells);
+
+    // corridors stay off the map edge, claim its rock up front
+    // stepping sideways off a row then always lands on a claimed edge cell
+    for(int x = 0; x < width; x++)
+    {
+        if(owner[x] < 0) owner[x] = -2;
+        if(owner[cells - width + x] < 0) owner[cells - width + x] = -2;
+    }
+    for(int y = 0; y < height; y++)
+    {
+        if(owner[y*width] < 0) owner[y*width] = -2;
+        if(owner[y*width + width - 1] < 0) owner[y*width + width - 1] = -2;
+    }
+
+    for(int i = 0; i < cells; i++)
+    {
+        if(labels[i] >= 0) queue.push_back(i);
+    }
+
+    const int steps[4] = {1, -1, width, -width};
+
+    for(int head = 0; head < int(queue.size()); head++)
+    {
+        int c = queue[head];
+
+        for(int d = 0; d < 4; d++)
+        {
+            int n = c + steps[d];
+            if(n < 0 || n >= cells || owner[n] != -1) continue;
+
+            owner[n] = owner[c];
+            dist[n] = dist[c] + 1;
+            from[n] = c;
+            queue.push_back(n);
+        }
+    }
+
+    // where two grown regions touch is the shortest path between their
+    // nearest cells, every touching pair is a candidate
+    std::vector<RegionLink> links;
+    int maxlength = 0;
+
+    for(int y = 0; y < height; y++)
+    {
+        for(int x = 0; x < width; x++)
+        {
+            int c = y*width + x;
+            if(owner[c] < 0) continue;
+
+            if(x < width - 1 && owner[c+1] >= 0 && owner[c+1] != owner[c])
+                links.push_back(RegionLink(dist[c] + dist[c+1], c, c+1));
+
+            if(y < height - 1 && owner[c+width] >= 0 && owner[c+width] != owner[c])
+                links.push_back(RegionLink(dist[c] + dist[c+width], c, c+width));
+        }
+    }
+
+    for(int i = 0; i < int(links.size()); i++) maxlength = std::max(maxlength, links[i].m_Length);
+
+    // order the links by length, lengths are small so count them into
+    // buckets, scan order is kept within a length
+    std::vector<int> bucket(maxlength + 2, 0);
+    for(int i = 0; i < int(links.size()); i++) bucket[links[i].m_Length + 1]++;
+    for(int i = 1; i < int(bucket.size()); i++) bucket[i] += bucket[i-1];
+
+    std::vector<RegionLink> sorted(links.size());
+    for(int i = 0; i < int(links.size()); i++) sorted[ bucket[links[i].m_Length]++ ] = links[i];
+
+    // shortest links first, keep the ones that join two unconnected
+    // groups, a minimum spanning tree over the regions
+    UnionFind groups(count);
+    int corridors = 0;
+
+    for(int i = 0; i < int(sorted.size()) && corridors < count - 1; i++)
+    {
+        const RegionLink &tlink = sorted[i];
+        if(!groups.unite(owner[tlink.m_A], owner[tlink.m_B])) continue;
+
+        // walk both halves back to their region
+        for(int c = tlink.m_A; dist[c] > 0; c = from[c]) tmap->setTileUnchecked(c % width, c / width, TILE_FLOOR);
+        for(int c = tlink.m_B; dist[c] > 0; c = from[c]) tmap->setTileUnchecked(c % width, c / width, TILE_FLOOR);
+
+        corridors++;
+    }
+
+    if(tinfo) tinfo->m_CorridorCount = corridors;
+}
+
+void LevelGenerator::addWallBorders(Map *tmap) const
+{
+    int width = tmap->getWidth();
+    int height = tmap->getHeight();
+    if(width <= 0 || height <= 0) return;
+
+    // floor cells dilated horizontally, one byte per cell
+    std::vector<unsigned char> near(width*height);
+
+    for(int y = 0; y < height; y++)
+    {
+        const int *row = tmap->getTileRow(y);
+        unsigned char *out = &near[y*width];
+
+        for(int x = 0; x < width; x++)
+        {
+            unsigned char left = x > 0 && row[x-1] == TILE_FLOOR;
+            unsigned char right = x < width - 1 && row[x+1] == TILE_FLOOR;
+
+            out[x] = left | right | (row[x] == TILE_FLOOR);
+        }
+    }
+
+    // empty cells next to floor, vertically dilated, become walls
+    std::vector<unsigned char> none(width, 0);
+    std::vector<int> newrow(width);
+
+    for(int y = 0; y < height; y++)
+    {
+        const int *row = tmap->getTileRow(y);
+        const unsigned char *above = y > 0 ? &near[(y-1)*width] : &none[0];
+        const unsigned char *mid = &near[y*width];
+        const unsigned char *below = y < height - 1 ? &near[(y+1)*width] : &none[0];
+
+        for(int x = 0; x < width; x++)
+        {
+            bool wall = row[x] == TILE_NONE && (above[x] | mid[x] | below[x]);
+            newrow[x] = wall ? TILE_WALL : row[x];
+        }
+
+        tmap->setTileRow(0, y, &newrow[0], width);
+    }
+}
+
+LevelJob::LevelJob(const LevelGenerator *tgen, Map *tmap, const Random &trng)
+{
+    m_Generator = tgen;
+    m_Map = tmap;
+    m_Random = trng;
+}
+
+void LevelJob::run()
+{
+    m_Generator->generate(m_Map, &m_Random);
+}
@@ -0,0 +1,254 @@
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <chrono>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include "datapaths.hpp"
+#include "map.hpp"
+#include "levelgen.hpp"
+#include "prefab.hpp"
+#include "random.hpp"
+#include "workerpool.hpp"
+#include "unionfind.hpp"
+
+// usage:
+//   levelstats [options]
+//     --seeds <first> <count>   seeds to sweep (default 1 100)
+//     --size <w>x<h>            map size, may be given more than once (default 100x100)
+//     --level <n>               dungeon level stream to generate (default 0)
+//     --density <f>             room placement attempts per tile
+//     --no-overlap              rooms may not overlap
+//     --caves                   cellular automata caves instead of rooms
+//     --no-connect              leave floor regions unconnected
+//     --prefabs <file>          prefab xml to stamp into rooms (default the game's)
+//     --no-prefabs              do not stamp prefabs
+//     --threads <n>             worker threads, 0 for all cores (default 0)
+//     --format csv|json         output format (default csv)
+//     --out <file>              write to file instead of stdout
+// levels are generated exactly as the game would for the same seed,
+// no display or game data is needed
+
+// result for one generated level
+struct LevelStats
+{
+    uint64_t m_Seed;
+    int m_Width;
+    int m_Height;
+    int m_RoomCount;
+    int m_PrefabCount;
+    int m_FloorCount;
+    int m_Components;
+    double m_Microseconds;
+};
+
+// count 4-connected regions of walkable tiles
+static int countComponents(const Map *tmap)
+{
+    int width = tmap->getWidth();
+    int height = tmap->getHeight();
+    if(width <= 0 || height <= 0) return 0;
+
+    std::vector<unsigned char> open(width*height);
+    for(int y = 0; y < height; y++)
+    {
+        for(int x = 0; x < width; x++) open[y*width + x] = !tmap->blocksMoveAt(x, y);
+    }
+
+    std::vector<int> labels;
+
+    return labelRegions(&open[0], width, height, &labels);
+}
+
+class StatsJob: public WorkerJob
+{
+private:
+
+    const LevelGenerator *m_Generator;
+    const std::vector<Tile> *m_TileSet;
+    int m_Level;
+    LevelStats *m_Stats;
+
+public:
+    StatsJob(const LevelGenerator *tgen, const std::vector<Tile> *ttiles, int level, LevelStats *tstats)
+    {
+        m_Generator = tgen;
+        m_TileSet = ttiles;
+        m_Level = level;
+        m_Stats = tstats;
+    }
+
+    void run()
+    {
+        Map tmap;
+        tmap.setTileSet(m_TileSet);
+        tmap.resize(m_Stats->m_Width, m_Stats->m_Height);
+
+        Random trng(m_Stats->m_Seed, getRandomStreamID(RNG_LEVEL, m_Level));
+        LevelGenInfo tinfo;
+
+        std::chrono::steady_clock::time_point starttime = std::chrono::steady_clock::now();
+        m_Generator->generate(&tmap, &trng, &tinfo);
+        std::chrono::steady_clock::time_point endtime = std::chrono::steady_clock::now();
+
+        m_Stats->m_Microseconds = std::chrono::duration<double, std::micro>(endtime - starttime).count();
+        m_Stats->m_RoomCount = tinfo.m_RoomCount;
+        m_Stats->m_PrefabCount = tinfo.m_PrefabCount;
+
+        m_Stats->m_FloorCount = 0;
+        for(int y = 0; y < m_Stats->m_Height; y++)
+        {
+            for(int x = 0; x < m_Stats->m_Width; x++)
+            {
+                if(!tmap.blocksMoveAt(x, y)) m_Stats->m_FloorCount++;
+            }
+        }
+
+        m_Stats->m_Components = countComponents(&tmap);
+    }
+};
+
+static void printStats(std::ostream &out, const LevelStats &tstats, bool json, bool first)
+{
+    double floorratio = double(tstats.m_FloorCount) / double(tstats.m_Width * tstats.m_Height);
+
+    if(json)
+    {
+        if(!first) out << ",\n";
+        out << "  {\"seed\":" << tstats.m_Seed << ",\"width\":" << tstats.m_Width << ",\"height\":" << tstats.m_Height;
+        out << ",\"floor_ratio\":" << floorratio << ",\"rooms\":" << tstats.m_RoomCount << ",\"prefabs\":" << tstats.m_PrefabCount;
+        out << ",\"components\":" << tstats.m_Components << ",\"gen_us\":" << tstats.m_Microseconds << "}";
+    }
+    else
+    {
+        out << tstats.m_Seed << "," << tstats.m_Width << "," << tstats.m_Height << ",";
+        out << floorratio << "," << tstats.m_RoomCount << "," << tstats.m_PrefabCount << "," << tstats.m_Components << ",";
+        out << tstats.m_Microseconds << "\n";
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    uint64_t firstseed = 1;
+    uint64_t seedcount = 100;
+    int level = 0;
+    int threads = 0;
+    bool json = false;
+    std::string outfile;
+    std::string prefabfile = PREFABS_XML;
+    std::vector<vector2i> sizes;
+
+    LevelGenerator tgen;
+
+    for(int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+
+        if(arg == "--seeds" && i + 2 < argc)
+        {
+            firstseed = strtoull(argv[++i], NULL, 10);
+            seedcount = strtoull(argv[++i], NULL, 10);
+        }
+        else if(arg == "--size" && i + 1 < argc)
+        {
+            vector2i tsize;
+            if(sscanf(argv[++i], "%dx%d", &tsize.x, &tsize.y) != 2 || tsize.x <= 0 || tsize.y <= 0)
+            {
+                std::cerr << "Invalid map size " << argv[i] << "\n";
+                return 1;
+            }
+            sizes.push_back(tsize);
+        }
+        else if(arg == "--level" && i + 1 < argc) level = atoi(argv[++i]);
+        else if(arg == "--density" && i + 1 < argc) tgen.setRoomDensity(atof(argv[++i]));
+        else if(arg == "--no-overlap") tgen.setAllowOverlap(false);
+        else if(arg == "--caves") tgen.setType(LEVEL_CAVES);
+        else if(arg == "--no-connect") tgen.setConnectRegions(false);
+        else if(arg == "--prefabs" && i + 1 < argc) prefabfile = argv[++i];
+        else if(arg == "--no-prefabs") prefabfile.clear();
+        else if(arg == "--threads" && i + 1 < argc) threads = atoi(argv[++i]);
+        else if(arg == "--format" && i + 1 < argc) json = !strcmp(argv[++i], "json");
+        else if(arg == "--out" && i + 1 < argc) outfile = argv[++i];
+        else
+        {
+            std::cerr << "Unknown option " << arg << "\n";
+            return 1;
+        }
+    }
+
+    if(sizes.empty()) sizes.push_back(vector2i(100,100));
+
+    // same prefabs the game stamps into its levels, they are optional there too
+    std::vector<Prefab> prefabs;
+    if(!prefabfile.empty() && loadPrefabsFromXML(prefabfile, &prefabs) < 0)
+        std::cerr << "Unable to load prefabs from " << prefabfile << ", generating without\n";
+    tgen.setPrefabs(&prefabs);
+
+    // generator only cares about walls and floors
+    // tile 0 = no tile, 1 = wall, 2 = floor
+    std::vector<Tile> tiles(3);
+    tiles[0].m_Glyph.m_Walkable = false;
+    tiles[1].m_Glyph.m_Walkable = false;
+    tiles[1].m_Glyph.m_PassesLight = false;
+
+    std::ofstream ofile;
+    if(!outfile.empty())
+    {
+        ofile.open(outfile.c_str());
+        if(!ofile.is_open())
+        {
+            std::cerr << "Unable to open " << outfile << "\n";
+            return 1;
+        }
+    }
+    std::ostream &out = outfile.empty() ? std::cout : ofile;
+
+    if(json) out << "[\n";
+    else out << "seed,width,height,floor_ratio,rooms,prefabs,components,gen_us\n";
+
+    WorkerPool workers;
+    workers.start(threads);
+
+    // run in batches so large sweeps do not hold every result at once
+    const uint64_t batchsize = 4096;
+    bool first = true;
+
+    for(int s = 0; s < int(sizes.size()); s++)
+    {
+        for(uint64_t batchstart = 0; batchstart < seedcount; batchstart += batchsize)
+        {
+            uint64_t count = seedcount - batchstart < batchsize ? seedcount - batchstart : batchsize;
+
+            std::vector<LevelStats> results(count);
+            std::vector<StatsJob*> jobs;
+
+            for(uint64_t i = 0; i < count; i++)
+            {
+                results[i].m_Seed = firstseed + batchstart + i;
+                results[i].m_Width = sizes[s].x;
+                results[i].m_Height = sizes[s].y;
+
+                jobs.push_back(new StatsJob(&tgen, &tiles, level, &results[i]));
+                workers.submit(jobs.back());
+            }
+
+            workers.waitAll();
+
+            for(uint64_t i = 0; i < count; i++)
+            {
+                printStats(out, results[i], json, first);
+                first = false;
+                delete jobs[i];
+            }
+        }
+    }
+
+    if(json) out << "\n]\n";
+
+    workers.stop();
+
+    return 0;
+}
@@ -1,12 +1,54 @@
 #include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <fstream>
 
 #include "engine.hpp"
 
+// usage:
+//   john
+//   john --headless <keyscript> [framelog]
+// headless mode runs without a terminal, reading keys from the script
+// file and optionally writing every rendered frame to the frame log
 int main(int argc, char *argv[])
 {
     Engine *engine;
     engine = Engine::getInstance();
-    
+
+    if(argc >= 3 && !strcmp(argv[1], "--headless"))
+    {
+        HeadlessDisplay *hdisplay = new HeadlessDisplay();
+
+        if(!hdisplay->loadKeys(argv[2]))
+        {
+            std::cerr << "Unable to open key script " << argv[2] << "\n";
+            delete hdisplay;
+            return 1;
+        }
+
+        std::ofstream framelog;
+        if(argc >= 4)
+        {
+            framelog.open(argv[3]);
+            hdisplay->setFrameLog(&framelog);
+        }
+
+        engine->setDisplay(hdisplay);
+
+        engine->start();
+
+        // wall clock, startup (data, first levels) is reported apart from the turns
+        double loopseconds = engine->getMainLoopTime();
+        double turnrate = loopseconds > 0 ? engine->getPlayerMoveCount() / loopseconds : 0;
+
+        std::cout << "keys:" << hdisplay->getKeyCount() << " frames:" << hdisplay->getFrameCount();
+        std::cout << " moves:" << engine->getPlayerMoveCount() << " startup_seconds:" << engine->getStartupTime();
+        std::cout << " loop_seconds:" << loopseconds << " turns_per_second:" << turnrate << "\n";
+        std::cout << hdisplay->getScreenText();
+
+        return 0;
+    }
+
     engine->start();
 
     return 0;
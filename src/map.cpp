@@ -1,9 +1,11 @@
 #include "map.hpp"
 #include <cstdlib>
+#include <cstring>
 #include "item.hpp"
 #include "actor.hpp"
-#include "console.hpp"
+#include "prefab.hpp"
 #include <sstream>
+#include <algorithm>
 
 // debug
 #include <iostream>
@@ -35,7 +37,7 @@ bool Tile::loadFromXMLNode(XMLNode *tnode)
     while(anode != NULL)
     {
 
-        if(!strcmp(anode->Value(),"name") ) m_Name = std::string(anode->ToElement()->GetText());
+        if(!strcmp(anode->Value(),"name") ) m_Name = Symbol(anode->ToElement()->GetText());
         else if(!strcmp(anode->Value(), "id"))
         {
             anode->ToElement()->QueryIntText(&m_ID);
@@ -55,7 +57,12 @@ bool Tile::loadFromXMLNode(XMLNode *tnode)
 //
 Map::Map()
 {
+    m_Width = 0;
+    m_Height = 0;
 
+    m_TileSet = NULL;
+
+    m_Time = 0;
 }
 
 Map::~Map()
@@ -63,109 +70,448 @@ Map::~Map()
     Map::clear();
 }
 
-vector2i Map::getDimensions() const
+void Map::clear()
+{
+    // detach every actor in the occupancy grid, this includes
+    // actors placed on the map that the map does not own
+    for(int i = 0; i < int(m_ActorCells.size()); i++)
+    {
+        if(m_ActorCells[i]) m_ActorCells[i]->m_Map = NULL;
+        m_ActorCells[i] = NULL;
+    }
+
+    // heap objects go one by one, pooled ones all at once
+    const std::vector<Item*> &items = m_Items.getObjects();
+    for(int i = 0; i < int(items.size()); i++)
+    {
+        if(items[i]->m_PoolSlot < 0) delete items[i];
+    }
+    m_Items.clear();
+    m_TickItems.clear();
+    std::fill(m_ItemCells.begin(), m_ItemCells.end(), (Item*)NULL);
+    m_ItemPool.releaseAll();
+    m_DoorPool.releaseAll();
+
+    const std::vector<Actor*> &actors = m_Actors.getObjects();
+    for(int i = 0; i < int(actors.size()); i++)
+    {
+        if(actors[i]->m_PoolSlot < 0) delete actors[i];
+    }
+    m_Actors.clear();
+    m_Scheduler.clear();
+    m_ActorPool.releaseAll();
+
+    std::fill(m_Array.begin(), m_Array.end(), 0);
+
+    refreshAllCells();
+}
+
+void Map::resize(unsigned int x, unsigned int y)
+{
+    std::vector<int> narray( size_t(x) * size_t(y), 0);
+
+    // keep whatever part of the old map still fits
+    int cwidth = std::min(int(x), m_Width);
+    int cheight = std::min(int(y), m_Height);
+
+    for(int i = 0; i < cheight; i++)
+    {
+        std::copy(m_Array.begin() + i*m_Width, m_Array.begin() + i*m_Width + cwidth, narray.begin() + i*int(x));
+    }
+
+    // keep occupants that are still within the new bounds
+    std::vector<Actor*> ocells;
+    ocells.swap(m_ActorCells);
+
+    m_Array.swap(narray);
+    m_Width = int(x);
+    m_Height = int(y);
+
+    rebuildItemCells();
+
+    m_ActorCells.assign(m_Array.size(), (Actor*)NULL);
+    for(int i = 0; i < int(ocells.size()); i++)
+    {
+        if(ocells[i]) occupyCell(ocells[i]);
+    }
+
+    refreshAllCells();
+}
+
+void Map::fill(unsigned int tileindex)
+{
+    std::fill(m_Array.begin(), m_Array.end(), int(tileindex));
+
+    refreshAllCells();
+}
+
+int Map::getMapTileIndexAt(unsigned int x, unsigned int y) const
+{
+    if( x >= unsigned(m_Width) || y >= unsigned(m_Height)) return -1;
+
+    return m_Array[y*m_Width + x];
+}
+
+int Map::getMapTileIndexAt(vector2i tpos) const
+{
+    return getMapTileIndexAt(tpos.x, tpos.y);
+}
+
+bool Map::setTileAt(unsigned int x, unsigned int y, int ttile)
 {
-    vector2i dims;
+    if( x >= unsigned(m_Width) || y >= unsigned(m_Height)) return false;
+
+    m_Array[y*m_Width + x] = ttile;
 
-    dims.y = int(m_Array.size());
-    dims.x = 0;
+    refreshCell(int(x), int(y));
 
-    if(dims.y != 0)
+    return true;
+}
+
+int Map::setTileRow(int x, int y, const int *ttiles, int count)
+{
+    if(ttiles == NULL || y < 0 || y >= m_Height) return 0;
+
+    // clip the run to the row
+    if(x < 0)
     {
-        dims.x = int(m_Array[0].size());
+        ttiles -= x;
+        count += x;
+        x = 0;
+    }
+    if(x + count > m_Width) count = m_Width - x;
+    if(count <= 0) return 0;
+
+    memcpy(&m_Array[y*m_Width + x], ttiles, count*sizeof(int));
+
+    return count;
+}
+
+int Map::fillTileRow(int x, int y, int count, int ttile)
+{
+    if(y < 0 || y >= m_Height) return 0;
 
-        // double check to make sure width is the same for each row
-        for(int i = 0; i < dims.y; i++)
+    if(x < 0)
+    {
+        count += x;
+        x = 0;
+    }
+    if(x + count > m_Width) count = m_Width - x;
+    if(count <= 0) return 0;
+
+    std::fill_n(m_Array.begin() + y*m_Width + x, count, ttile);
+
+    return count;
+}
+
+void Map::fillRect(const recti &trect, int ttile)
+{
+    int y1 = std::max(trect.y, 0);
+    int y2 = std::min(trect.y + trect.height, m_Height);
+
+    for(int y = y1; y < y2; y++) fillTileRow(trect.x, y, trect.width, ttile);
+}
+
+void Map::copyRegion(const Map *srcmap, const recti &srcrect, int x, int y)
+{
+    if(srcmap == NULL) return;
+
+    recti src = srcrect;
+
+    // clip against the source map, moving the destination along
+    if(src.x < 0) { x -= src.x; src.width += src.x; src.x = 0;}
+    if(src.y < 0) { y -= src.y; src.height += src.y; src.y = 0;}
+    src.width = std::min(src.width, srcmap->m_Width - src.x);
+    src.height = std::min(src.height, srcmap->m_Height - src.y);
+
+    // and against this map
+    if(x < 0) { src.x -= x; src.width += x; x = 0;}
+    if(y < 0) { src.y -= y; src.height += y; y = 0;}
+    src.width = std::min(src.width, m_Width - x);
+    src.height = std::min(src.height, m_Height - y);
+
+    if(src.width <= 0 || src.height <= 0) return;
+
+    // copying down within the same map has to go bottom up
+    bool bottomup = srcmap == this && y > src.y;
+
+    for(int i = 0; i < src.height; i++)
+    {
+        int row = bottomup ? src.height - 1 - i : i;
+
+        memmove(&m_Array[(y + row)*m_Width + x], &srcmap->m_Array[(src.y + row)*srcmap->m_Width + src.x], src.width*sizeof(int));
+    }
+}
+
+void Map::stampPrefab(const Prefab *tprefab, int x, int y)
+{
+    if(tprefab == NULL) return;
+
+    int x1 = std::max(x, 0);
+    int x2 = std::min(x + tprefab->m_Width, m_Width);
+    int y1 = std::max(y, 0);
+    int y2 = std::min(y + tprefab->m_Height, m_Height);
+
+    for(int ty = y1; ty < y2; ty++)
+    {
+        const int *srcrow = tprefab->getTileRow(ty - y);
+        const unsigned char *maskrow = tprefab->getMaskRow(ty - y);
+        int *dstrow = &m_Array[ty*m_Width];
+
+        for(int tx = x1; tx < x2; tx++)
         {
-            if( int(m_Array[i].size()) != dims.x)
-            {
-                printw("ERROR, map dimension widths not consistent when y = %d", i);
-                getch();
-                exit(1);
-            }
+            int px = tx - x;
+            dstrow[tx] = maskrow[px] ? srcrow[px] : dstrow[tx];
         }
     }
-
-    return dims;
 }
 
-void Map::clear()
+void Map::setTileSet(const std::vector<Tile> *ttiles)
 {
+    m_TileSet = ttiles;
 
-    for(int i = 0; i < int(m_Items.size()); i++) delete m_Items[i];
-    m_Items.clear();
+    refreshAllCells();
+}
 
-    for(int i = 0; i < int(m_Actors.size()); i++) delete m_Actors[i];
-    m_Actors.clear();
+void Map::refreshCell(int x, int y)
+{
+    if(!isInBounds(x, y)) return;
 
-    for(int i = 0; i < int(m_Array.size()); i++)
+    bool blight = false;
+    bool bmove = false;
+
+    // tile flags, unknown tiles block everything
+    if(m_TileSet)
     {
-        for(int n = 0; n < int(m_Array[i].size()); n++)
+        int ti = m_Array[y*m_Width + x];
+
+        if(ti < 0 || ti >= int(m_TileSet->size()) )
         {
-            m_Array[i][n] = 0;
+            blight = true;
+            bmove = true;
+        }
+        else
+        {
+            const glyph *tglyph = &(*m_TileSet)[ti].m_Glyph;
+            blight = !tglyph->m_PassesLight;
+            bmove = !tglyph->m_Walkable;
         }
     }
+
+    // item flags (ie. closed doors)
+    for(Item *titem = m_ItemCells[y*m_Width + x]; titem != NULL; titem = titem->getNextItemInCell())
+    {
+        if(!titem->passesLight()) blight = true;
+        if(!titem->isWalkable()) bmove = true;
+    }
+
+    // actors block movement
+    if(m_ActorCells[y*m_Width + x]) bmove = true;
+
+    unsigned int i = unsigned(y*m_Width + x);
+    uint64_t mask = uint64_t(1) << (i & 63);
+
+    if(blight) m_BlocksLight[i >> 6] |= mask;
+    else m_BlocksLight[i >> 6] &= ~mask;
+
+    if(bmove) m_BlocksMove[i >> 6] |= mask;
+    else m_BlocksMove[i >> 6] &= ~mask;
 }
 
-void Map::resize(unsigned int x, unsigned int y)
+bool Map::findOpenCell(vector2i tpos, vector2i *found) const
 {
-    m_Array.resize( int(y));
+    // ring radius that reaches the farthest corner
+    int maxradius = std::max( std::max(tpos.x, m_Width - 1 - tpos.x), std::max(tpos.y, m_Height - 1 - tpos.y) );
 
-    for(int i = 0; i < int(y); i++)
+    // search square rings of growing radius around tpos
+    for(int r = 0; r <= maxradius; r++)
     {
-        m_Array[i].resize(int(x));
+        for(int y = tpos.y - r; y <= tpos.y + r; y++)
+        {
+            // only the left and right edges on the inner rows
+            int xstep = (r == 0 || y == tpos.y - r || y == tpos.y + r) ? 1 : 2*r;
+
+            for(int x = tpos.x - r; x <= tpos.x + r; x += xstep)
+            {
+                if(!isInBounds(x, y) || blocksMoveAt(x, y)) continue;
+
+                if(found) *found = vector2i(x, y);
+                return true;
+            }
+        }
     }
+
+    return false;
 }
 
-void Map::fill(unsigned int tileindex)
+void Map::refreshAllCells()
 {
+    m_BlocksLight.assign( (m_Array.size() + 63) / 64, 0);
+    m_BlocksMove.assign( (m_Array.size() + 63) / 64, 0);
+
+    // tile flags and occupants, unknown tiles block everything
+    int tilecount = m_TileSet ? int(m_TileSet->size()) : 0;
+
     for(int i = 0; i < int(m_Array.size()); i++)
     {
-        for(int n = 0; n < int(m_Array[i].size()); n++)
+        bool blight = false;
+        bool bmove = m_ActorCells[i] != NULL;
+
+        if(m_TileSet)
         {
-            m_Array[i][n] = tileindex;
+            int ti = m_Array[i];
+
+            if(ti < 0 || ti >= tilecount)
+            {
+                blight = true;
+                bmove = true;
+            }
+            else
+            {
+                const glyph *tglyph = &(*m_TileSet)[ti].m_Glyph;
+                if(!tglyph->m_PassesLight) blight = true;
+                if(!tglyph->m_Walkable) bmove = true;
+            }
         }
+
+        uint64_t mask = uint64_t(1) << (i & 63);
+        if(blight) m_BlocksLight[i >> 6] |= mask;
+        if(bmove) m_BlocksMove[i >> 6] |= mask;
+    }
+
+    // item flags from the store, items off the map are skipped
+    const vector2i *ipos = m_Items.getPositions();
+    const unsigned char *iflags = m_Items.getFlags();
+
+    for(int i = 0; i < m_Items.size(); i++)
+    {
+        if(!iflags[i] || !isInBounds(ipos[i].x, ipos[i].y)) continue;
+
+        unsigned int ci = unsigned(ipos[i].y*m_Width + ipos[i].x);
+        uint64_t mask = uint64_t(1) << (ci & 63);
+
+        if(iflags[i] & ENT_BLOCKSLIGHT) m_BlocksLight[ci >> 6] |= mask;
+        if(iflags[i] & ENT_BLOCKSMOVE) m_BlocksMove[ci >> 6] |= mask;
     }
 }
 
-int Map::getMapTileIndexAt(unsigned int x, unsigned int y) const
+void Map::refreshRect(const recti &trect)
 {
-    vector2i dims = getDimensions();
-
-    if( int(x) >= dims.x || int(y) >= dims.y) return -1;
+    int x1 = std::max(trect.x, 0);
+    int x2 = std::min(trect.x + trect.width, m_Width);
+    int y1 = std::max(trect.y, 0);
+    int y2 = std::min(trect.y + trect.height, m_Height);
 
-    return m_Array[y][x];
+    for(int i = y1; i < y2; i++)
+    {
+        for(int n = x1; n < x2; n++) refreshCell(n, i);
+    }
 }
 
-int Map::getMapTileIndexAt(vector2i tpos) const
+
+
+void Map::linkItem(Item *titem)
 {
-    return getMapTileIndexAt(tpos.x, tpos.y);
+    vector2i ipos = titem->getPosition();
+
+    titem->m_CellPrev = NULL;
+    titem->m_CellNext = NULL;
+
+    // items off the map are tracked, but not indexed
+    if(!isInBounds(ipos.x, ipos.y)) return;
+
+    Item **head = &m_ItemCells[ipos.y*m_Width + ipos.x];
+
+    titem->m_CellNext = *head;
+    if(*head) (*head)->m_CellPrev = titem;
+    *head = titem;
 }
 
-bool Map::setTileAt(unsigned int x, unsigned int y, int ttile)
+void Map::unlinkItem(Item *titem)
 {
-    vector2i dims = getDimensions();
+    if(titem->m_CellPrev) titem->m_CellPrev->m_CellNext = titem->m_CellNext;
+    else
+    {
+        // item is either first in its cell or not linked at all
+        vector2i ipos = titem->getPosition();
 
-    if(int(x) >= dims.x || int(y) >= dims.y) return false;
+        if(isInBounds(ipos.x, ipos.y) && m_ItemCells[ipos.y*m_Width + ipos.x] == titem)
+            m_ItemCells[ipos.y*m_Width + ipos.x] = titem->m_CellNext;
+    }
 
-    m_Array[y][x] = ttile;
+    if(titem->m_CellNext) titem->m_CellNext->m_CellPrev = titem->m_CellPrev;
 
-    return true;
+    titem->m_CellPrev = NULL;
+    titem->m_CellNext = NULL;
 }
 
+void Map::rebuildItemCells()
+{
+    m_ItemCells.assign(m_Array.size(), (Item*)NULL);
 
+    const std::vector<Item*> &items = m_Items.getObjects();
+    for(int i = 0; i < int(items.size()); i++) linkItem(items[i]);
+}
 
 bool Map::addItem(Item* nitem)
 {
     if(nitem == NULL) return false;
-    m_Items.push_back(nitem);
+    nitem->m_Handle = m_Items.insert(nitem);
+
+    if(nitem->needsUpdate()) m_TickItems.push_back(nitem->m_Handle);
+
+    nitem->m_Map = this;
+    linkItem(nitem);
+
+    vector2i ipos = nitem->getPosition();
+    refreshCell(ipos.x, ipos.y);
+
     return true;
 }
 
+void Map::occupyCell(Actor *tactor)
+{
+    vector2i apos = tactor->getPosition();
+
+    if(!isInBounds(apos.x, apos.y)) return;
+
+    m_ActorCells[apos.y*m_Width + apos.x] = tactor;
+}
+
+void Map::vacateCell(Actor *tactor, vector2i tpos)
+{
+    if(!isInBounds(tpos.x, tpos.y)) return;
+
+    // only clear the cell if this actor is the one occupying it
+    if(m_ActorCells[tpos.y*m_Width + tpos.x] == tactor)
+        m_ActorCells[tpos.y*m_Width + tpos.x] = NULL;
+}
+
 bool Map::addActor(Actor *nactor)
 {
     if(nactor == NULL) return false;
-    m_Actors.push_back(nactor);
+    nactor->m_Handle = m_Actors.insert(nactor);
+
+    // first action is one action delay from now
+    m_Scheduler.schedule(nactor->m_Handle, m_Time + nactor->getActionDelay());
+
+    return placeActor(nactor);
+}
+
+// place actor in the occupancy grid without taking ownership (ie. the player)
+bool Map::placeActor(Actor *tactor)
+{
+    if(tactor == NULL) return false;
+
+    // actor can only be on one map at a time
+    if(tactor->m_Map && tactor->m_Map != this) tactor->m_Map->detachActor(tactor);
+
+    tactor->m_Map = this;
+    occupyCell(tactor);
+
+    vector2i apos = tactor->getPosition();
+    refreshCell(apos.x, apos.y);
+
     return true;
 }
 
@@ -173,125 +519,249 @@ std::vector<Item*> Map::getItemsAt(int x, int y)
 {
     std::vector<Item*> ilist;
 
-    for(int i = 0; i < int(m_Items.size()); i++)
+    for(Item *titem = getFirstItemAt(x, y); titem != NULL; titem = titem->getNextItemInCell())
     {
-        vector2i ipos = m_Items[i]->getPosition();
-
-        if(ipos.x == x && ipos.y == y) ilist.push_back(m_Items[i]);
+        ilist.push_back(titem);
     }
 
     return ilist;
 }
 
+Item *Map::getFirstItemAt(int x, int y) const
+{
+    if(!isInBounds(x, y)) return NULL;
+
+    return m_ItemCells[y*m_Width + x];
+}
+
 Item *Map::removeItemFromMap(Item *titem)
 {
     if(titem == NULL) return NULL;
+    if(titem->m_Map != this || !m_Items.remove(titem->m_Handle)) return NULL;
+
+    unlinkItem(titem);
+    titem->m_Map = NULL;
+    titem->m_Handle = EntityHandle();
+
+    vector2i ipos = titem->getPosition();
+    refreshCell(ipos.x, ipos.y);
 
-    for(int i = 0; i < int(m_Items.size()); i++)
+    // pooled memory goes away with the level, give the caller its own copy
+    if(m_ItemPool.owns(titem, titem->m_PoolSlot))
     {
-        if(m_Items[i] == titem)
-        {
-            m_Items.erase( m_Items.begin() + i);
+        Item *hitem = new Item(*titem);
+        m_ItemPool.destroy(titem, titem->m_PoolSlot);
 
-            return titem;
-        }
+        return hitem;
     }
 
-    return NULL;
+    return titem;
+}
+
+Item *Map::createItem(const Item &tproto, int x, int y)
+{
+    if(!isInBounds(x, y)) return NULL;
+
+    int slot;
+    Item *nitem = m_ItemPool.create(tproto, &m_DoorPool, &slot);
+    nitem->m_PoolSlot = slot;
+    nitem->setPosition(x, y);
+
+    addItem(nitem);
+
+    return nitem;
+}
+
+Actor *Map::createActor(const Actor &tproto, int x, int y)
+{
+    if(!isInBounds(x, y)) return NULL;
+
+    int slot;
+    Actor *nactor = m_ActorPool.create(tproto, &slot);
+    nactor->m_PoolSlot = slot;
+    nactor->setPosition(x, y);
+
+    addActor(nactor);
+
+    return nactor;
 }
 
 bool Map::openDoorAt(int x, int y)
 {
-    for(int i = 0; i < int(m_Items.size()); i++)
+    for(Item *titem = getFirstItemAt(x, y); titem != NULL; titem = titem->getNextItemInCell())
     {
-        if(m_Items[i]->getPosition().x == x && m_Items[i]->getPosition().y == y)
+        if(titem->getDoor())
         {
-            if(m_Items[i]->getDoor())
-            {
-                m_Items[i]->openDoor();
+            titem->openDoor();
 
-                return m_Items[i]->getDoor()->isOpen();
-            }
+            return titem->getDoor()->isOpen();
         }
     }
 
     return false;
 }
 
-Actor *Map::getActorAt(int x, int y)
+Actor *Map::getActorAt(int x, int y) const
+{
+    if(!isInBounds(x, y)) return NULL;
+
+    return m_ActorCells[y*m_Width + x];
+}
+
+Actor *Map::removeActorFromMap(Actor *tactor)
 {
-    Actor *tactor = NULL;
+    if(!detachActor(tactor)) return NULL;
 
-    for(int i = 0; i < int(m_Actors.size()); i++)
+    // pooled memory goes away with the level, give the caller its own copy
+    if(m_ActorPool.owns(tactor, tactor->m_PoolSlot))
     {
-        vector2i ipos = m_Actors[i]->getPosition();
+        Actor *hactor = new Actor(*tactor);
+        m_ActorPool.destroy(tactor, tactor->m_PoolSlot);
 
-        if(ipos.x == x && ipos.y == y) tactor = m_Actors[i];
+        return hactor;
     }
 
     return tactor;
 }
 
-Actor *Map::removeActorFromMap(Actor *tactor)
+void Map::destroyActor(Actor *tactor)
 {
-    if(tactor == NULL) return NULL;
+    detachActor(tactor);
 
-    for(int i = 0; i < int(m_Actors.size()); i++)
+    if(m_ActorPool.owns(tactor, tactor->m_PoolSlot)) m_ActorPool.destroy(tactor, tactor->m_PoolSlot);
+    else delete tactor;
+}
+
+bool Map::detachActor(Actor *tactor)
+{
+    if(tactor == NULL) return false;
+    if(tactor->m_Map != this) return false;
+
+    vector2i apos = tactor->getPosition();
+    vacateCell(tactor, apos);
+    tactor->m_Map = NULL;
+    refreshCell(apos.x, apos.y);
+
+    // its scheduler entry goes stale with the handle
+    m_Actors.remove(tactor->m_Handle);
+    tactor->m_Handle = EntityHandle();
+
+    return true;
+}
+
+void Map::objectMoved(WorldObject *tobj, vector2i oldpos)
+{
+    if(tobj == NULL) return;
+
+    if(tobj->getType() == OBJ_ITEM)
     {
-        if(m_Actors[i] == tactor)
-        {
-            m_Actors.erase( m_Actors.begin() + i);
+        Item *titem = static_cast<Item*>(tobj);
 
-            return tactor;
-        }
+        // unlink using the old position, then relink at the new one
+        vector2i npos = titem->getPosition();
+        titem->m_Position = oldpos;
+        unlinkItem(titem);
+        titem->m_Position = npos;
+        linkItem(titem);
+
+        m_Items.setPosition(titem->m_Handle, npos);
     }
+    else if(tobj->getType() == OBJ_ACTOR)
+    {
+        Actor *tactor = static_cast<Actor*>(tobj);
+
+        vacateCell(tactor, oldpos);
+        occupyCell(tactor);
+
+        m_Actors.setPosition(tactor->m_Handle, tactor->getPosition());
+    }
+
+    // update flags of the cell left and the cell entered
+    vector2i npos = tobj->getPosition();
+    refreshCell(oldpos.x, oldpos.y);
+    refreshCell(npos.x, npos.y);
+}
+
+void Map::objectChanged(WorldObject *tobj)
+{
+    if(tobj == NULL) return;
+
+    if(tobj->getType() == OBJ_ITEM) m_Items.sync(tobj->m_Handle);
+    else if(tobj->getType() == OBJ_ACTOR) m_Actors.sync(tobj->m_Handle);
 
-    return NULL;
+    vector2i tpos = tobj->getPosition();
+    refreshCell(tpos.x, tpos.y);
 }
 
 void Map::update()
 {
-    // update map items
-    for(int i = 0; i < int(m_Items.size()); i++) m_Items[i]->update();
+    // advance map time by one turn
+    m_Time += TURN_TICKS;
 
-    // update map actors
-    for(int i = int(m_Actors.size())-1; i >= 0 ; i--)
+    // update map items that have behavior, dropping removed ones
+    int kept = 0;
+    for(int i = 0; i < int(m_TickItems.size()); i++)
     {
-        m_Actors[i]->update();
+        Item *titem = getItem(m_TickItems[i]);
+        if(titem == NULL) continue;
+
+        m_TickItems[kept++] = m_TickItems[i];
+        titem->update();
+    }
+    m_TickItems.resize(kept);
+
+    // update map actors whose next action is due
+    long acttime = 0;
+    EntityHandle thandle;
+
+    while( !(thandle = m_Scheduler.popReady(m_Time, &acttime)).isNull() )
+    {
+        // actor was removed since it was scheduled
+        Actor *tactor = getActor(thandle);
+        if(tactor == NULL) continue;
+
+        tactor->update();
 
         // if actor is dead
-        if(!m_Actors[i]->isAlive())
+        if(!tactor->isAlive())
         {
-            // get actor reference
-            Actor *tactor = m_Actors[i];
-
-            // remove actor from map
-            removeActorFromMap(m_Actors[i]);
+            // remove actor from map and free it
+            destroyActor(tactor);
 
-            // delete actor
-            delete tactor;
+            continue;
         }
+
+        // actor left the map during its update
+        if(tactor->getMap() != this) continue;
+
+        // wake up again after this action's delay
+        m_Scheduler.schedule(thandle, acttime + tactor->getActionDelay());
     }
 }
 
 void Map::printInfo() const
 {
-    Console *console = NULL;
-    console = Console::getInstance();
-
     std::stringstream sstr;
 
-    console->print("Map Info");
-    console->print("--------");
+    printInfoLine("Map Info");
+    printInfoLine("--------");
     sstr << "Dimensions : " << getDimensions().x << "," << getDimensions().y;
-    console->print(sstr.str());
+    printInfoLine(sstr.str());
 
     sstr.str(std::string());
     sstr << "Item Count : " << m_Items.size();
-    console->print(sstr.str());
+    printInfoLine(sstr.str());
 
     sstr.str(std::string());
     sstr << "Actor Count : " << m_Actors.size();
-    console->print(sstr.str());
+    printInfoLine(sstr.str());
+
+    sstr.str(std::string());
+    sstr << "Scheduled Actors : " << m_Scheduler.size();
+    printInfoLine(sstr.str());
+
+    sstr.str(std::string());
+    sstr << "Ticked Items : " << m_TickItems.size();
+    printInfoLine(sstr.str());
 
 }
@@ -0,0 +1,105 @@
+#include "prefab.hpp"
+#include "levelgen.hpp"
+
+#include <cstring>
+
+Prefab::Prefab()
+{
+    m_Name = "unnamed";
+    m_Width = 0;
+    m_Height = 0;
+}
+
+Prefab::~Prefab()
+{
+
+}
+
+bool Prefab::loadFromXMLNode(XMLNode *tnode)
+{
+    if(tnode == NULL) return false;
+
+    // character to tile index, -1 is masked out
+    int keys[256];
+    for(int i = 0; i < 256; i++) keys[i] = -1;
+    keys[int('#')] = TILE_WALL;
+    keys[int('.')] = TILE_FLOOR;
+
+    std::vector<std::string> rows;
+
+    XMLNode *anode = tnode->FirstChild();
+
+    while(anode != NULL)
+    {
+        if(!strcmp(anode->Value(), "name") && anode->ToElement()->GetText()) m_Name = std::string(anode->ToElement()->GetText());
+        else if(!strcmp(anode->Value(), "row"))
+        {
+            const char *trow = anode->ToElement()->GetText();
+            rows.push_back( trow ? std::string(trow) : std::string(""));
+        }
+        else if(!strcmp(anode->Value(), "key"))
+        {
+            XMLElement *charnode = anode->FirstChildElement("char");
+            XMLElement *tilenode = anode->FirstChildElement("tile");
+            int ttile = -1;
+
+            if(charnode && charnode->GetText() && tilenode && !tilenode->QueryIntText(&ttile))
+            {
+                keys[ (unsigned char)(charnode->GetText()[0]) ] = ttile;
+            }
+        }
+
+        anode = anode->NextSibling();
+    }
+
+    m_Height = int(rows.size());
+    m_Width = 0;
+    for(int i = 0; i < m_Height; i++) if(int(rows[i].size()) > m_Width) m_Width = int(rows[i].size());
+
+    m_Tiles.assign(m_Width*m_Height, 0);
+    m_Mask.assign(m_Width*m_Height, 0);
+
+    // short rows are padded with masked out cells
+    for(int y = 0; y < m_Height; y++)
+    {
+        for(int x = 0; x < int(rows[y].size()); x++)
+        {
+            int ttile = keys[ (unsigned char)(rows[y][x]) ];
+            if(ttile < 0) continue;
+
+            m_Tiles[y*m_Width + x] = ttile;
+            m_Mask[y*m_Width + x] = 1;
+        }
+    }
+
+    return m_Width > 0 && m_Height > 0;
+}
+
+int loadPrefabsFromXML(std::string xfile, std::vector<Prefab> *prefabs)
+{
+    tinyxml2::XMLDocument tdoc;
+    if(tdoc.LoadFile(xfile.c_str())) return -1;
+
+    XMLNode *root = tdoc.FirstChild();
+    if(root == NULL) return -1;
+
+    XMLNode *prefabsnode = root->FirstChildElement("prefabs");
+    if(prefabsnode == NULL) return 0;
+
+    int count = 0;
+    XMLNode *tnode = prefabsnode->FirstChildElement("prefab");
+
+    while(tnode != NULL)
+    {
+        Prefab newprefab;
+        if(newprefab.loadFromXMLNode(tnode))
+        {
+            prefabs->push_back(newprefab);
+            count++;
+        }
+
+        tnode = tnode->NextSiblingElement("prefab");
+    }
+
+    return count;
+}
@@ -0,0 +1,114 @@
+#include "random.hpp"
+
+static inline uint64_t rotl(uint64_t x, int k)
+{
+    return (x << k) | (x >> (64 - k));
+}
+
+static uint64_t splitMix64(uint64_t *x)
+{
+    uint64_t z = (*x += 0x9E3779B97F4A7C15ULL);
+
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+
+    return z ^ (z >> 31);
+}
+
+Random::Random()
+{
+    seed(0);
+}
+
+Random::Random(uint64_t nseed)
+{
+    seed(nseed);
+}
+
+Random::Random(uint64_t nseed, uint64_t nstream)
+{
+    seed(nseed, nstream);
+}
+
+void Random::seed(uint64_t nseed, uint64_t nstream)
+{
+    // mix the stream id in first so nearby seeds and streams do not correlate
+    uint64_t sm = nstream;
+    uint64_t x = nseed ^ splitMix64(&sm);
+
+    for(int i = 0; i < 4; i++) m_State[i] = splitMix64(&x);
+
+    // all zero state would only ever produce zeroes
+    if(!(m_State[0] | m_State[1] | m_State[2] | m_State[3])) m_State[0] = 1;
+}
+
+uint64_t Random::next()
+{
+    const uint64_t result = rotl(m_State[1] * 5, 7) * 9;
+    const uint64_t t = m_State[1] << 17;
+
+    m_State[2] ^= m_State[0];
+    m_State[3] ^= m_State[1];
+    m_State[1] ^= m_State[2];
+    m_State[0] ^= m_State[3];
+
+    m_State[2] ^= t;
+    m_State[3] = rotl(m_State[3], 45);
+
+    return result;
+}
+
+void Random::jump()
+{
+    static const uint64_t JUMP[] = { 0x180EC6D33CFD0ABAULL, 0xD5A61266F0C9392CULL,
+                                     0xA9582618E03FC9AAULL, 0x39ABDC4529B1661CULL };
+
+    uint64_t s[4] = {0, 0, 0, 0};
+
+    for(int i = 0; i < 4; i++)
+    {
+        for(int b = 0; b < 64; b++)
+        {
+            if(JUMP[i] & (uint64_t(1) << b))
+            {
+                for(int n = 0; n < 4; n++) s[n] ^= m_State[n];
+            }
+            next();
+        }
+    }
+
+    for(int n = 0; n < 4; n++) m_State[n] = s[n];
+}
+
+Random Random::split()
+{
+    Random child = *this;
+    jump();
+
+    return child;
+}
+
+int Random::getInt(int nmax)
+{
+    if(nmax <= 0) return 0;
+
+    // reject the top partial range so every value is equally likely
+    const uint64_t range = uint64_t(nmax);
+    const uint64_t limit = ~uint64_t(0) - (~uint64_t(0) % range);
+
+    uint64_t r = next();
+    while(r >= limit) r = next();
+
+    return int(r % range);
+}
+
+int Random::getRange(int nmin, int nmax)
+{
+    return nmin + getInt(nmax - nmin);
+}
+
+double Random::getDouble()
+{
+    // top 53 bits fill the double mantissa
+    return double(next() >> 11) * (1.0 / 9007199254740992.0);
+}
@@ -0,0 +1,88 @@
+#include "rectindex.hpp"
+
+#include <algorithm>
+
+static inline bool rectsOverlap(const recti &a, const recti &b)
+{
+    return a.x < b.x + b.width && b.x < a.x + a.width &&
+           a.y < b.y + b.height && b.y < a.y + a.height;
+}
+
+RectIndex::RectIndex()
+{
+    m_Width = 0;
+    m_Height = 0;
+    m_BucketSize = 1;
+    m_BucketsX = 0;
+    m_BucketsY = 0;
+}
+
+RectIndex::~RectIndex()
+{
+
+}
+
+void RectIndex::reset(int width, int height, int bucketsize)
+{
+    m_Width = std::max(width, 0);
+    m_Height = std::max(height, 0);
+    m_BucketSize = std::max(bucketsize, 1);
+
+    m_BucketsX = (m_Width + m_BucketSize - 1) / m_BucketSize;
+    m_BucketsY = (m_Height + m_BucketSize - 1) / m_BucketSize;
+
+    m_Rects.clear();
+    m_Buckets.clear();
+    m_Buckets.resize(m_BucketsX * m_BucketsY);
+}
+
+void RectIndex::clear()
+{
+    m_Rects.clear();
+
+    for(int i = 0; i < int(m_Buckets.size()); i++) m_Buckets[i].clear();
+}
+
+void RectIndex::add(const recti &trect)
+{
+    if(trect.width <= 0 || trect.height <= 0) return;
+
+    int index = int(m_Rects.size());
+    m_Rects.push_back(trect);
+
+    // clamp the covered buckets to the grid
+    int bx1 = std::max(trect.x / m_BucketSize, 0);
+    int by1 = std::max(trect.y / m_BucketSize, 0);
+    int bx2 = std::min( (trect.x + trect.width - 1) / m_BucketSize, m_BucketsX - 1);
+    int by2 = std::min( (trect.y + trect.height - 1) / m_BucketSize, m_BucketsY - 1);
+
+    for(int by = by1; by <= by2; by++)
+    {
+        for(int bx = bx1; bx <= bx2; bx++) m_Buckets[by*m_BucketsX + bx].push_back(index);
+    }
+}
+
+bool RectIndex::overlaps(const recti &trect) const
+{
+    if(trect.width <= 0 || trect.height <= 0) return false;
+
+    int bx1 = std::max(trect.x / m_BucketSize, 0);
+    int by1 = std::max(trect.y / m_BucketSize, 0);
+    int bx2 = std::min( (trect.x + trect.width - 1) / m_BucketSize, m_BucketsX - 1);
+    int by2 = std::min( (trect.y + trect.height - 1) / m_BucketSize, m_BucketsY - 1);
+
+    for(int by = by1; by <= by2; by++)
+    {
+        for(int bx = bx1; bx <= bx2; bx++)
+        {
+            const std::vector<int> &bucket = m_Buckets[by*m_BucketsX + bx];
+
+            for(int i = 0; i < int(bucket.size()); i++)
+            {
+                if(rectsOverlap(trect, m_Rects[bucket[i]])) return true;
+            }
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,129 @@
+#include "renderer.hpp"
+#include "display.hpp"
+#include "glyph.hpp"
+
+// front buffer value that never matches a real cell
+static const chtype INVALID_CELL = ~chtype(0);
+
+Renderer::Renderer()
+{
+    m_Display = NULL;
+
+    m_Width = 0;
+    m_Height = 0;
+
+    m_FullRedraw = true;
+}
+
+Renderer::~Renderer()
+{
+
+}
+
+void Renderer::setDisplay(Display *tdisplay)
+{
+    m_Display = tdisplay;
+    m_FullRedraw = true;
+}
+
+void Renderer::resize(int nwidth, int nheight)
+{
+    if(nwidth < 0) nwidth = 0;
+    if(nheight < 0) nheight = 0;
+
+    m_Width = nwidth;
+    m_Height = nheight;
+
+    m_BackBuffer.assign( size_t(m_Width) * size_t(m_Height), chtype(' '));
+    m_FrontBuffer.assign( m_BackBuffer.size(), INVALID_CELL);
+
+    m_FullRedraw = true;
+}
+
+void Renderer::clear()
+{
+    int twidth = 0;
+    int theight = 0;
+
+    if(m_Display)
+    {
+        twidth = m_Display->getWidth();
+        theight = m_Display->getHeight();
+    }
+
+    if(twidth != m_Width || theight != m_Height) resize(twidth, theight);
+    else std::fill(m_BackBuffer.begin(), m_BackBuffer.end(), chtype(' '));
+}
+
+void Renderer::put(int x, int y, chtype ch)
+{
+    if(x < 0 || y < 0 || x >= m_Width || y >= m_Height) return;
+
+    m_BackBuffer[y*m_Width + x] = ch;
+}
+
+int Renderer::print(int x, int y, const std::string &str, chtype attr)
+{
+    for(int i = 0; i < int(str.length()); i++)
+    {
+        if(x >= m_Width) break;
+
+        put(x, y, chtype( (unsigned char)str[i]) | attr);
+        x++;
+    }
+
+    return x;
+}
+
+chtype Renderer::getAt(int x, int y) const
+{
+    if(x < 0 || y < 0 || x >= m_Width || y >= m_Height) return chtype(' ');
+
+    return m_BackBuffer[y*m_Width + x];
+}
+
+void Renderer::setCursor(int x, int y)
+{
+    m_Cursor = vector2i(x, y);
+}
+
+void Renderer::present()
+{
+    if(m_Display == NULL) return;
+
+    if(m_FullRedraw)
+    {
+        // something else may have drawn to the display, start over
+        m_Display->clearScreen();
+        std::fill(m_FrontBuffer.begin(), m_FrontBuffer.end(), INVALID_CELL);
+        m_FullRedraw = false;
+    }
+
+    for(int i = 0; i < m_Height; i++)
+    {
+        for(int n = 0; n < m_Width; n++)
+        {
+            int ci = i*m_Width + n;
+
+            if(m_BackBuffer[ci] == m_FrontBuffer[ci]) continue;
+
+            m_Display->putCell(n, i, m_BackBuffer[ci]);
+            m_FrontBuffer[ci] = m_BackBuffer[ci];
+        }
+    }
+
+    m_Display->setCursor(m_Cursor.x, m_Cursor.y);
+    m_Display->flush();
+}
+
+void Renderer::invalidate()
+{
+    m_FullRedraw = true;
+}
+
+// glyphs draw through the renderer, defined here so the glyph code
+// itself builds without the display side
+void glyph::draw(Renderer *trender, int x, int y) const
+{
+    trender->put(x, y, m_Render);
+}
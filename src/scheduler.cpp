@@ -0,0 +1,59 @@
+#include "scheduler.hpp"
+#include <algorithm>
+
+Scheduler::Scheduler()
+{
+    m_NextOrder = 0;
+}
+
+Scheduler::~Scheduler()
+{
+
+}
+
+bool Scheduler::later(const Entry &a, const Entry &b)
+{
+    if(a.m_Time != b.m_Time) return a.m_Time > b.m_Time;
+
+    return a.m_Order > b.m_Order;
+}
+
+void Scheduler::schedule(EntityHandle tactor, long ttime)
+{
+    if(tactor.isNull()) return;
+
+    Entry nentry;
+    nentry.m_Time = ttime;
+    nentry.m_Order = m_NextOrder++;
+    nentry.m_Actor = tactor;
+
+    m_Heap.push_back(nentry);
+    std::push_heap(m_Heap.begin(), m_Heap.end(), &Scheduler::later);
+}
+
+void Scheduler::clear()
+{
+    m_Heap.clear();
+}
+
+long Scheduler::getNextTime() const
+{
+    if(m_Heap.empty()) return -1;
+
+    return m_Heap.front().m_Time;
+}
+
+EntityHandle Scheduler::popReady(long ttime, long *acttime)
+{
+    if(m_Heap.empty()) return EntityHandle();
+    if(m_Heap.front().m_Time > ttime) return EntityHandle();
+
+    Entry tentry = m_Heap.front();
+
+    std::pop_heap(m_Heap.begin(), m_Heap.end(), &Scheduler::later);
+    m_Heap.pop_back();
+
+    if(acttime) *acttime = tentry.m_Time;
+
+    return tentry.m_Actor;
+}
@@ -0,0 +1,104 @@
+#include "symbol.hpp"
+#include <cstring>
+
+// fnv-1a
+static unsigned int hashString(const char *str, size_t len)
+{
+    unsigned int hash = 2166136261u;
+
+    for(size_t i = 0; i < len; i++)
+    {
+        hash ^= (unsigned char)str[i];
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+Symbol::Table::Table()
+{
+    m_Buckets.assign(64, 0);
+
+    // id 0 is always the empty string
+    find("", 0, true);
+}
+
+void Symbol::Table::grow()
+{
+    std::vector<unsigned int> nbuckets(m_Buckets.size() * 2, 0);
+    unsigned int mask = unsigned(nbuckets.size()) - 1;
+
+    for(unsigned int id = 0; id < m_Hashes.size(); id++)
+    {
+        unsigned int b = m_Hashes[id] & mask;
+        while(nbuckets[b]) b = (b + 1) & mask;
+
+        nbuckets[b] = id + 1;
+    }
+
+    m_Buckets.swap(nbuckets);
+}
+
+unsigned int Symbol::Table::find(const char *str, size_t len, bool add)
+{
+    unsigned int hash = hashString(str, len);
+    unsigned int mask = unsigned(m_Buckets.size()) - 1;
+    unsigned int b = hash & mask;
+
+    for(; m_Buckets[b]; b = (b + 1) & mask)
+    {
+        unsigned int id = m_Buckets[b] - 1;
+        const std::string &tstr = m_Strings[id];
+
+        if(m_Hashes[id] == hash && tstr.length() == len && !memcmp(tstr.data(), str, len)) return id;
+    }
+
+    if(!add) return 0;
+
+    unsigned int id = unsigned(m_Strings.size());
+    m_Strings.push_back(std::string(str, len));
+    m_Hashes.push_back(hash);
+    m_Buckets[b] = id + 1;
+
+    // keep the load under one half
+    if(m_Strings.size() * 2 > m_Buckets.size()) grow();
+
+    return id;
+}
+
+Symbol::Table &Symbol::getTable()
+{
+    static Table table;
+
+    return table;
+}
+
+Symbol::Symbol(const std::string &str)
+{
+    m_ID = getTable().find(str.data(), str.length(), true);
+}
+
+Symbol::Symbol(const char *str)
+{
+    m_ID = str ? getTable().find(str, strlen(str), true) : 0;
+}
+
+Symbol::Symbol(const char *str, size_t len)
+{
+    m_ID = getTable().find(str, len, true);
+}
+
+Symbol Symbol::lookup(const char *str, size_t len)
+{
+    return Symbol( getTable().find(str, len, false) );
+}
+
+int Symbol::getCount()
+{
+    return getTable().getCount();
+}
+
+const std::string &Symbol::str() const
+{
+    return getTable().getString(m_ID);
+}
@@ -1,5 +1,8 @@
 #include "tools.hpp"
 #include <cmath>
+#include <iostream>
+
+static InfoPrinter infoprinter = NULL;
 
 vector2i::vector2i()
 {
@@ -67,3 +70,14 @@ int getIndexFromChar(char c)
     else if( int(c) >= numbase && int(c) < numbase+9) return int(c) - numbase + (26*2);
     else return -1;
 }
+
+void setInfoPrinter(InfoPrinter tprinter)
+{
+    infoprinter = tprinter;
+}
+
+void printInfoLine(const std::string &str)
+{
+    if(infoprinter) infoprinter(str);
+    else std::cout << str << std::endl;
+}
@@ -0,0 +1,95 @@
+#include "unionfind.hpp"
+
+UnionFind::UnionFind()
+{
+
+}
+
+UnionFind::UnionFind(int count)
+{
+    reset(count);
+}
+
+UnionFind::~UnionFind()
+{
+
+}
+
+void UnionFind::reset(int count)
+{
+    m_Parent.resize(count);
+    m_Size.assign(count, 1);
+
+    for(int i = 0; i < count; i++) m_Parent[i] = i;
+}
+
+int UnionFind::find(int a)
+{
+    while(m_Parent[a] != a)
+    {
+        m_Parent[a] = m_Parent[m_Parent[a]];
+        a = m_Parent[a];
+    }
+
+    return a;
+}
+
+bool UnionFind::unite(int a, int b)
+{
+    a = find(a);
+    b = find(b);
+
+    if(a == b) return false;
+
+    // hang the smaller tree under the larger
+    if(m_Size[a] < m_Size[b])
+    {
+        int t = a;
+        a = b;
+        b = t;
+    }
+
+    m_Parent[b] = a;
+    m_Size[a] += m_Size[b];
+
+    return true;
+}
+
+int labelRegions(const unsigned char *open, int width, int height, std::vector<int> *labels)
+{
+    int cells = width * height;
+
+    labels->assign(cells, -1);
+    if(cells <= 0) return 0;
+
+    // join every open cell with its open left and upper neighbors
+    UnionFind sets(cells);
+
+    for(int y = 0; y < height; y++)
+    {
+        for(int x = 0; x < width; x++)
+        {
+            int i = y*width + x;
+            if(!open[i]) continue;
+
+            if(x > 0 && open[i-1]) sets.unite(i, i-1);
+            if(y > 0 && open[i-width]) sets.unite(i, i-width);
+        }
+    }
+
+    // number the roots in the order they are first seen
+    std::vector<int> rootlabel(cells, -1);
+    int count = 0;
+
+    for(int i = 0; i < cells; i++)
+    {
+        if(!open[i]) continue;
+
+        int root = sets.find(i);
+        if(rootlabel[root] < 0) rootlabel[root] = count++;
+
+        (*labels)[i] = rootlabel[root];
+    }
+
+    return count;
+}
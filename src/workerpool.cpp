@@ -0,0 +1,130 @@
+#include "workerpool.hpp"
+
+#include <algorithm>
+
+WorkerPool::WorkerPool()
+{
+    m_Pending = 0;
+    m_Stopping = false;
+}
+
+WorkerPool::~WorkerPool()
+{
+    stop();
+}
+
+void WorkerPool::start(int nthreads)
+{
+    if(!m_Threads.empty()) return;
+
+    if(nthreads <= 0) nthreads = int(std::thread::hardware_concurrency());
+    if(nthreads <= 0) nthreads = 1;
+
+    m_Stopping = false;
+
+    for(int i = 0; i < nthreads; i++) m_Threads.push_back( std::thread(&WorkerPool::workerLoop, this));
+}
+
+void WorkerPool::stop()
+{
+    // let the workers drain the queue before shutting down
+    waitAll();
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Stopping = true;
+    }
+    m_JobReady.notify_all();
+
+    for(int i = 0; i < int(m_Threads.size()); i++) m_Threads[i].join();
+    m_Threads.clear();
+}
+
+void WorkerPool::workerLoop()
+{
+    while(1)
+    {
+        WorkerJob *tjob = NULL;
+
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            while(m_Queue.empty() && !m_Stopping) m_JobReady.wait(lock);
+
+            if(m_Queue.empty()) return;
+
+            tjob = m_Queue.front();
+            m_Queue.pop_front();
+            tjob->m_Queued = false;
+        }
+
+        tjob->run();
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            tjob->m_Done = true;
+            m_Pending--;
+        }
+        m_JobDone.notify_all();
+    }
+}
+
+void WorkerPool::submit(WorkerJob *tjob)
+{
+    if(tjob == NULL) return;
+
+    // no workers, just do it now
+    if(m_Threads.empty())
+    {
+        tjob->m_Done = false;
+        tjob->run();
+        tjob->m_Done = true;
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        tjob->m_Done = false;
+        tjob->m_Queued = true;
+        m_Queue.push_back(tjob);
+        m_Pending++;
+    }
+    m_JobReady.notify_one();
+}
+
+bool WorkerPool::isDone(WorkerJob *tjob)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    return tjob->m_Done;
+}
+
+void WorkerPool::wait(WorkerJob *tjob)
+{
+    std::unique_lock<std::mutex> lock(m_Mutex);
+
+    // still sitting in the queue, take it back and run it on this thread
+    if(tjob->m_Queued)
+    {
+        m_Queue.erase( std::find(m_Queue.begin(), m_Queue.end(), tjob));
+        tjob->m_Queued = false;
+        lock.unlock();
+
+        tjob->run();
+
+        lock.lock();
+        tjob->m_Done = true;
+        m_Pending--;
+        lock.unlock();
+        m_JobDone.notify_all();
+        return;
+    }
+
+    while(!tjob->m_Done) m_JobDone.wait(lock);
+}
+
+void WorkerPool::waitAll()
+{
+    std::unique_lock<std::mutex> lock(m_Mutex);
+
+    while(m_Pending > 0) m_JobDone.wait(lock);
+}
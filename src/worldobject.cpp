@@ -1,36 +1,106 @@
 #include "worldobject.hpp"
-#include "console.hpp"
+#include "map.hpp"
 #include <sstream>
 
 using namespace tinyxml2;
 
-WorldObject::WorldObject()
+ObjectDef::ObjectDef()
 {
+    m_ID = -1;
+
     m_Name = "unnamed";
 
-    m_ID = -1;
+    m_RefCount = 1;
+}
+
+ObjectDef::ObjectDef(const ObjectDef &tdef)
+{
+    m_ID = tdef.m_ID;
+    m_Name = tdef.m_Name;
+    m_Article = tdef.m_Article;
+
+    // a copy starts out with a single user
+    m_RefCount = 1;
+}
+
+WorldObject::WorldObject()
+{
+    m_Def = new ObjectDef;
 
+    m_Map = NULL;
+    m_PoolSlot = -1;
 }
 
 WorldObject::WorldObject(const WorldObject &tobj)
 {
+    m_Def = NULL;
+
     *this = tobj;
 }
 
 WorldObject::~WorldObject()
 {
+    releaseDef();
+}
+
+// copies share the definition, only per object state is duplicated
+WorldObject &WorldObject::operator=(const WorldObject &tobj)
+{
+    if(this == &tobj) return *this;
+
+    if(m_Def != tobj.m_Def)
+    {
+        releaseDef();
+        m_Def = tobj.m_Def;
+        m_Def->m_RefCount++;
+    }
+
+    m_Position = tobj.m_Position;
+    m_Glyph = tobj.m_Glyph;
+
+    // copies are not placed on any map
+    m_Map = NULL;
+    m_Handle = EntityHandle();
+    m_PoolSlot = -1;
 
+    return *this;
+}
+
+void WorldObject::releaseDef()
+{
+    if(m_Def && --m_Def->m_RefCount == 0) delete m_Def;
+
+    m_Def = NULL;
+}
+
+ObjectDef *WorldObject::editDef()
+{
+    if(m_Def->m_RefCount > 1)
+    {
+        const ObjectDef *shared = m_Def;
+
+        m_Def = new ObjectDef(*shared);
+        shared->m_RefCount--;
+    }
+
+    return const_cast<ObjectDef*>(m_Def);
 }
 
 void WorldObject::setName(std::string nname, std::string narticle)
 {
-    m_Name = nname;
-    m_Article = narticle;
+    ObjectDef *tdef = editDef();
+
+    tdef->m_Name = nname;
+    tdef->m_Article = narticle;
 }
 
 void WorldObject::setPosition(vector2i npos)
 {
+    vector2i opos = m_Position;
     m_Position = npos;
+
+    // let the map keep its spatial index up to date
+    if(m_Map) m_Map->objectMoved(this, opos);
 }
 
 void WorldObject::setPosition(int nx, int ny)
@@ -38,26 +108,55 @@ void WorldObject::setPosition(int nx, int ny)
     setPosition(vector2i(nx, ny));
 }
 
+void WorldObject::setWalkable(bool nwalkable)
+{
+    m_Glyph.m_Walkable = nwalkable;
+
+    // cell flags on the map depend on this
+    if(m_Map) m_Map->objectChanged(this);
+}
+
+void WorldObject::setPassesLight(bool nplight)
+{
+    m_Glyph.m_PassesLight = nplight;
+
+    // cell flags on the map depend on this
+    if(m_Map) m_Map->objectChanged(this);
+}
+
+void WorldObject::setIcon(chtype nicon)
+{
+    m_Glyph.m_Character = nicon;
+    m_Glyph.resolve();
+
+    // the map keeps a copy of the render glyph
+    if(m_Map) m_Map->objectChanged(this);
+}
+
 void WorldObject::setColors(int foreground, int background, bool bold)
 {
     COLOR tcolor(foreground, background, bold);
     m_Glyph.m_Color = tcolor;
+    m_Glyph.resolve();
+
+    if(m_Map) m_Map->objectChanged(this);
 }
 
 bool WorldObject::loadFromXMLNode(XMLNode *tnode)
 {
     XMLNode *anode = NULL;
+    ObjectDef *tdef = editDef();
 
     anode = tnode->FirstChild();
 
     while(anode != NULL)
     {
 
-        if(!strcmp(anode->Value(),"name") ) m_Name = std::string(anode->ToElement()->GetText());
-        else if(!strcmp(anode->Value(), "id")) anode->ToElement()->QueryIntText(&m_ID);
+        if(!strcmp(anode->Value(),"name") ) tdef->m_Name = Symbol(anode->ToElement()->GetText());
+        else if(!strcmp(anode->Value(), "id")) anode->ToElement()->QueryIntText(&tdef->m_ID);
         else if(!strcmp(anode->Value(), "article"))
         {
-            m_Article = anode->ToElement()->GetText();
+            tdef->m_Article = Symbol(anode->ToElement()->GetText());
         }
         else if(!strcmp(anode->Value(), "glyph"))
         {
@@ -72,14 +171,13 @@ bool WorldObject::loadFromXMLNode(XMLNode *tnode)
 
 void WorldObject::printInfo() const
 {
-    Console *console = Console::getInstance();
-    console->print("");
-    console->print("Name:" + m_Name);
-    console->print("Article:" + m_Article);
+    printInfoLine("");
+    printInfoLine("Name:" + m_Def->m_Name.str());
+    printInfoLine("Article:" + m_Def->m_Article.str());
 
     std::stringstream ss;
     ss << "Position:" << m_Position.x << "," << m_Position.y;
-    console->print(ss.str() );
+    printInfoLine(ss.str() );
     ss.str(std::string());
 
     // print glyph info